@@ -0,0 +1,163 @@
+// 증분 재어셈블 벤치마크 (임의 편집마다 증분 결과와 처음부터 다시 어셈블한 결과를 바이트 단위 비교)
+// 빌드: g++ -std=c++17 -O2 -pthread -o incremental_bench bench/incremental_bench.cpp $(ls src/*.cpp | grep -v main.cpp)
+// 실행: ./incremental_bench [소스파일] [편집 횟수] [시드] (생략하면 pass2_bench가 만든 /tmp/pass2_bench.asm, 200회)
+// 작업 디렉터리 아래 input/, output/을 쓴다
+#include "../include/assembler.h"
+#include <chrono>
+#include <random>
+#include <sys/stat.h>
+
+static std::string readAll(const std::string &filename) {
+    SourceFile file;
+    return file.open(filename) ? std::string(file.contents()) : std::string();
+}
+
+static std::string artifacts() {
+    return readAll("output/OBJFILE") + readAll("output/SYMTAB.txt") + readAll("output/LITTAB.txt") +
+           readAll("output/INTFILE");
+}
+
+static std::vector<std::string> splitLines(const std::string &text) {
+    std::vector<std::string> lines;
+    std::istringstream in(text);
+    std::string line;
+    while (std::getline(in, line)) {
+        lines.push_back(line);
+    }
+    return lines;
+}
+
+static std::string joinLines(const std::vector<std::string> &lines) {
+    std::string text;
+    for (const std::string &line : lines) {
+        text += line + "\n";
+    }
+    return text;
+}
+
+// 라벨이 있는 줄에서 라벨 하나를 고른다 (피연산자로 쓰기 위해, START의 프로그램 이름은 제외)
+static std::string pickLabel(const std::vector<std::string> &lines, std::mt19937 &rng) {
+    for (int tries = 0; tries < 32; ++tries) {
+        const std::string &line = lines[1 + rng() % (lines.size() - 1)];
+        if (!line.empty() && line[0] != ' ' && line[0] != '#') {
+            return line.substr(0, line.find_first_of(" \t"));
+        }
+    }
+    return "0";
+}
+
+// 줄을 바꿔 쓸 때 라벨은 남긴다 (WORD 피연산자가 정의되지 않은 심볼이 되지 않도록)
+static std::string labelField(const std::string &line) {
+    if (line.empty() || std::isspace(static_cast<unsigned char>(line[0])) || line[0] == '#') {
+        return std::string(9, ' ');
+    }
+    std::string label = line.substr(0, line.find_first_of(" \t"));
+    label.resize(std::max<size_t>(label.size() + 1, 9), ' ');
+    return label;
+}
+
+// 주로 위치만 바꾸는 편집, 가끔 전체 재어셈블이 필요한 편집 (리터럴, 앞쪽의 EQU)
+static void mutate(std::vector<std::string> &lines, std::mt19937 &rng, int serial) {
+    size_t at = 1 + rng() % (lines.size() - 2); // START와 END는 건드리지 않는다
+    std::string target = pickLabel(lines, rng);
+    std::string label = "N" + std::to_string(serial);
+    label.resize(9, ' ');
+    switch (rng() % 20) {
+    case 0:
+        lines.insert(lines.begin() + at, "         LDA     " + target);
+        break;
+    case 1:
+        lines.insert(lines.begin() + at, label + "+JSUB   " + target);
+        break;
+    case 2:
+        // 라벨 줄을 지우면 WORD 피연산자가 정의되지 않은 심볼이 될 수 있으므로 라벨 없는 줄만
+        if (lines[at].empty() || lines[at][0] == ' ') {
+            lines.erase(lines.begin() + at);
+        }
+        break;
+    case 3:
+        lines[at] = labelField(lines[at]) + "STA     " + target + ",X";
+        break;
+    case 4:
+        lines.insert(lines.begin() + at, label + "RESB    " + std::to_string(rng() % 40));
+        break;
+    case 5:
+        lines.insert(lines.begin() + at, "         BASE    " + target);
+        break;
+    case 6:
+        lines.insert(lines.begin() + at, label + "WORD    " + target);
+        break;
+    case 7:
+        lines[at] = labelField(lines[at]) + "CLEAR   X";
+        break;
+    case 8:
+        lines.insert(lines.begin() + at, "         LDT     =X'0" + std::to_string(serial % 10) + "'");
+        break;
+    case 9:
+        lines.insert(lines.begin() + 1 + at % 8, label + "EQU     *");
+        break;
+    default:
+        lines[at] = labelField(lines[at]) + "LDA     " + target;
+        break;
+    }
+}
+
+int main(int argc, char **argv) {
+    std::string sourceName = argc > 1 ? argv[1] : "/tmp/pass2_bench.asm";
+    int edits = argc > 2 ? std::atoi(argv[2]) : 200;
+    std::vector<std::string> lines = splitLines(readAll(sourceName));
+    if (lines.size() < 3) {
+        std::cerr << "Cannot open " << sourceName << " (run pass2_bench first or pass a source file)" << std::endl;
+        return 1;
+    }
+    mkdir("input", 0755);
+    mkdir("output", 0755);
+
+    OPTAB optab;
+    IncrementalAssembler incremental(&optab);
+    std::mt19937 rng(argc > 3 ? std::atoi(argv[3]) : 12345);
+    // 증분으로 처리한 편집과 전체 재어셈블로 넘어간 편집은 따로 잰다
+    double incrementalTime = 0, fallbackTime = 0, fullTime = 0;
+    int fallbacks = 0;
+
+    std::ostringstream quiet;
+    Console::redirect(&quiet, &quiet);
+    for (int k = 0; k <= edits; ++k) {
+        if (k > 0) {
+            mutate(lines, rng, k);
+        }
+        std::ofstream("input/SRCFILE") << joinLines(lines);
+
+        auto t0 = std::chrono::steady_clock::now();
+        incremental.assemble("input/SRCFILE");
+        auto t1 = std::chrono::steady_clock::now();
+        incremental.writeOutputs();
+        std::string updated = artifacts();
+
+        IncrementalAssembler full(&optab);
+        auto t2 = std::chrono::steady_clock::now();
+        full.assemble("input/SRCFILE");
+        auto t3 = std::chrono::steady_clock::now();
+        full.writeOutputs();
+        if (k > 0) {
+            bool fallback = quiet.str().find("reassembling everything") != std::string::npos;
+            (fallback ? fallbackTime : incrementalTime) += std::chrono::duration<double>(t1 - t0).count();
+            fallbacks += fallback ? 1 : 0;
+            fullTime += std::chrono::duration<double>(t3 - t2).count();
+        }
+        if (artifacts() != updated) {
+            Console::redirect(nullptr, nullptr);
+            std::cout << "MISMATCH after edit " << k << std::endl;
+            return 1;
+        }
+        quiet.str("");
+    }
+    Console::redirect(nullptr, nullptr);
+
+    int updates = edits - fallbacks;
+    std::cout << edits << " edits on " << lines.size() << " lines: incremental " << std::fixed
+              << std::setprecision(2) << incrementalTime * 1000 / std::max(updates, 1) << " ms/edit (" << updates
+              << "), reassembled " << fallbackTime * 1000 / std::max(fallbacks, 1) << " ms/edit (" << fallbacks
+              << "), full " << fullTime * 1000 / edits << " ms/edit, identical" << std::endl;
+    return 0;
+}
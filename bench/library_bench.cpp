@@ -0,0 +1,91 @@
+// 라이브러리 API 벤치마크 (Assembler::assemble 반복 호출 시간, 구조화된 레코드와 OBJFILE 텍스트 비교)
+// 빌드: g++ -std=c++17 -O2 -pthread -o library_bench bench/library_bench.cpp $(ls src/*.cpp | grep -v main.cpp)
+// 실행: ./library_bench [소스파일] [반복 횟수] (생략하면 내장 예제 소스, 20000회)
+#include "../include/assembler.h"
+#include <chrono>
+
+static const char *SAMPLE =
+    "COPY     START   1000\n"
+    "FIRST    STL     RETADR\n"
+    "         LDB     #LENGTH\n"
+    "         BASE    LENGTH\n"
+    "CLOOP    +JSUB   RDREC\n"
+    "         LDA     LENGTH\n"
+    "         COMP    #0\n"
+    "         JEQ     ENDFIL\n"
+    "         J       CLOOP\n"
+    "ENDFIL   LDA     =C'EOF'\n"
+    "         STA     BUFFER\n"
+    "         J       @RETADR\n"
+    "         LTORG\n"
+    "RETADR   RESW    1\n"
+    "LENGTH   RESW    1\n"
+    "BUFFER   RESB    4096\n"
+    "RDREC    CLEAR   X\n"
+    "         LDT     #4096\n"
+    "         TIXR    T\n"
+    "         RSUB\n"
+    "         END     FIRST\n";
+
+static std::string readAll(const std::string &filename) {
+    SourceFile file;
+    return file.open(filename) ? std::string(file.contents()) : std::string();
+}
+
+static std::string hex(uint32_t value, int digits) {
+    std::ostringstream out;
+    out << std::hex << std::uppercase << std::setfill('0') << std::setw(digits) << value;
+    std::string text = out.str();
+    return text.substr(text.size() - static_cast<size_t>(digits));
+}
+
+// 구조화된 레코드를 OBJFILE 형식으로 다시 만든다
+static std::string format(const ObjectProgram &program) {
+    std::string name = program.name;
+    name.resize(6, ' ');
+    std::string out = "H" + name + hex(program.startAddress, 6) + hex(program.length, 6) + "\n";
+    for (const TextRecord &record : program.textRecords) {
+        out += "T" + hex(record.address, 6) + hex(static_cast<uint32_t>(record.bytes.size()), 2);
+        for (uint8_t byte : record.bytes) {
+            out += hex(byte, 2);
+        }
+        out += "\n";
+    }
+    for (const ModificationRecord &record : program.modificationRecords) {
+        out += "M" + hex(record.address, 6) + hex(record.length, 2) + "\n";
+    }
+    return out + "E" + hex(program.firstExecAddress, 6) + "\n";
+}
+
+int main(int argc, char **argv) {
+    std::string source = argc > 1 ? readAll(argv[1]) : SAMPLE;
+    int rounds = argc > 2 ? std::atoi(argv[2]) : 20000;
+    if (source.empty() || rounds <= 0) {
+        std::cerr << "Cannot open " << argv[1] << std::endl;
+        return 1;
+    }
+
+    AssemblyOptions options;
+    options.objectText = true;
+    AssemblyResult checked = Assembler::assemble(source, options);
+    bool same = checked.ok && format(checked.program) == checked.objectText;
+    std::cout << (checked.ok ? "ok" : "FAILED") << ": " << checked.program.textRecords.size() << " text records, "
+              << checked.symbols.size() << " symbols, " << checked.literals.size() << " literals, "
+              << checked.diagnostics.size() << " diagnostics, records "
+              << (same ? "identical to OBJFILE text" : "MISMATCH") << std::endl;
+    if (!same) {
+        return 1;
+    }
+
+    // 레코드만 받는 기본 옵션으로 반복 호출
+    auto t0 = std::chrono::steady_clock::now();
+    size_t records = 0;
+    for (int r = 0; r < rounds; ++r) {
+        records += Assembler::assemble(source).program.textRecords.size();
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    double seconds = std::chrono::duration<double>(t1 - t0).count();
+    std::cout << rounds << " calls: " << std::fixed << std::setprecision(2) << seconds * 1e6 / rounds
+              << " us/call (" << records / rounds << " text records each)" << std::endl;
+    return 0;
+}
@@ -0,0 +1,125 @@
+// 스트리밍 OBJFILE 출력 벤치마크 (Pass 2 뒤에 한 번에 쓰기 vs 레코드를 만드는 대로 쓰기)
+// 스레드 수별로 두 방식의 OBJFILE을 바이트 단위로 비교하고, Pass 2가 아레나에서 받아 간 메모리를 잰다
+// 빌드: g++ -std=c++17 -O2 -pthread -o objstream_bench bench/objstream_bench.cpp $(ls src/*.cpp | grep -v main.cpp)
+// 실행: ./objstream_bench [소스파일] (생략하면 합성 소스 사용)
+#include "../include/assembler.h"
+#include <chrono>
+
+static std::string makeSource(int lines) {
+    std::string src = "BENCH    START   0\n";
+    for (int i = 0; i < lines; ++i) {
+        std::string label = "L" + std::to_string(i);
+        label.resize(9, ' ');
+        std::string target = "L" + std::to_string((i * 7) % lines);
+        switch (i % 4) {
+        case 0:
+            src += label + "+JSUB   " + target + "\n";
+            break;
+        case 1:
+            src += label + "LDA     #" + std::to_string(i % 4096) + "\n";
+            break;
+        case 2:
+            src += label + "WORD    " + target + "\n";
+            break;
+        default:
+            src += label + "BYTE    X'" + std::string(8, 'A') + "'\n";
+            break;
+        }
+    }
+    return src + "         END     BENCH\n";
+}
+
+// 아레나가 위쪽 자원에서 받아 간 바이트 수 (monotonic 아레나는 돌려주지 않으므로 곧 최대 사용량)
+class CountingResource : public std::pmr::memory_resource {
+public:
+    size_t allocated = 0;
+
+private:
+    void *do_allocate(size_t bytes, size_t alignment) override {
+        allocated += bytes;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+    void do_deallocate(void *p, size_t bytes, size_t alignment) override {
+        std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+    bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override {
+        return this == &other;
+    }
+};
+
+static std::string readAll(const std::string &filename) {
+    SourceFile file;
+    return file.open(filename) ? std::string(file.contents()) : std::string();
+}
+
+// Pass 2를 한 번 실행하고 OBJFILE 내용, 시간(Pass 2 + 쓰기), 아레나 사용량을 돌려준다
+static double runPass2(const OPTAB &optab, SymbolPool &pool, SYMTAB &symtab, LITTAB &littab, Pass1 &pass1,
+                       ThreadPool *workers, bool streaming, std::string &object, size_t &arenaBytes) {
+    std::ostringstream quiet;
+    Console::redirect(&quiet, &quiet);
+    CountingResource upstream;
+    auto t0 = std::chrono::steady_clock::now();
+    {
+        std::pmr::monotonic_buffer_resource arena(&upstream);
+        Pass2 pass2(&optab, &symtab, &littab, &pool, pass1.getIntFile(), pass1.getStartAddress(),
+                    pass1.getProgramLength(), pass1.getProgramName(), pass1.getProgramBlocks(), &arena, workers);
+        if (streaming) {
+            pass2.streamTo("/tmp/objstream_bench.obj");
+            pass2.execute();
+        } else {
+            pass2.execute();
+            pass2.writeObjFile("/tmp/objstream_bench.obj");
+        }
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    Console::redirect(nullptr, nullptr);
+    object = readAll("/tmp/objstream_bench.obj");
+    arenaBytes = upstream.allocated;
+    return std::chrono::duration<double>(t1 - t0).count();
+}
+
+int main(int argc, char **argv) {
+    std::string source = argc > 1 ? argv[1] : "/tmp/objstream_bench.asm";
+    if (argc <= 1) {
+        std::ofstream(source) << makeSource(400000);
+    }
+
+    OPTAB optab;
+    SymbolPool pool(&optab);
+    SYMTAB symtab(&pool);
+    LITTAB littab(&pool);
+    Pass1 pass1(&optab, &symtab, &littab, &pool);
+    {
+        std::ostringstream quiet;
+        Console::redirect(&quiet, &std::cerr);
+        bool ok = pass1.execute(source);
+        Console::redirect(nullptr, nullptr);
+        if (!ok) {
+            std::cerr << "Pass 1 failed" << std::endl;
+            return 1;
+        }
+    }
+    symtab.setProgramBlocks(&pass1.getProgramBlocks());
+
+    for (size_t threads : {size_t(1), size_t(4)}) {
+        ThreadPool workers(threads);
+        std::string buffered, streamed;
+        size_t bufferedBytes = 0, streamedBytes = 0;
+        double bufferedTime = 1e30, streamedTime = 1e30;
+        for (int r = 0; r < 3; ++r) {
+            bufferedTime = std::min(bufferedTime, runPass2(optab, pool, symtab, littab, pass1, &workers, false,
+                                                           buffered, bufferedBytes));
+            streamedTime = std::min(streamedTime, runPass2(optab, pool, symtab, littab, pass1, &workers, true,
+                                                           streamed, streamedBytes));
+        }
+        bool same = !buffered.empty() && buffered == streamed;
+        std::cout << threads << " thread(s), " << pass1.getIntFile().size() << " lines, " << buffered.size()
+                  << " byte OBJFILE: buffered " << std::fixed << std::setprecision(2) << bufferedTime * 1000
+                  << " ms / " << bufferedBytes / 1024 << " KiB arena, streamed " << streamedTime * 1000 << " ms / "
+                  << streamedBytes / 1024 << " KiB arena, " << (same ? "identical" : "MISMATCH") << std::endl;
+        if (!same) {
+            return 1;
+        }
+    }
+    return 0;
+}
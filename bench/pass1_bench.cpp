@@ -0,0 +1,71 @@
+// Pass 1 병렬 준비 단계 벤치마크 (스레드 수별 시간, 직렬 결과와 바이트 단위 비교)
+// 빌드: g++ -std=c++17 -O2 -pthread -o pass1_bench bench/pass1_bench.cpp $(ls src/*.cpp | grep -v main.cpp)
+// 실행: ./pass1_bench [소스파일] (생략하면 pass2_bench가 만든 /tmp/pass2_bench.asm 사용)
+#include "../include/assembler.h"
+#include <chrono>
+
+static std::string readAll(const std::string &filename) {
+    SourceFile file;
+    return file.open(filename) ? std::string(file.contents()) : std::string();
+}
+
+// 한 번 실행하고 중간 파일(텍스트/이진), SYMTAB, 콘솔 출력을 모은다
+static double runPass1(const std::string &source, ThreadPool *workers, std::string &artifacts) {
+    std::ostringstream captured;
+    Console::redirect(&captured, &captured);
+
+    std::pmr::monotonic_buffer_resource arena;
+    OPTAB optab;
+    SymbolPool pool(&optab, &arena);
+    SYMTAB symtab(&pool, &arena);
+    LITTAB littab(&pool, &arena);
+    Pass1 pass1(&optab, &symtab, &littab, &pool, &arena, workers);
+    auto t0 = std::chrono::steady_clock::now();
+    pass1.execute(source);
+    auto t1 = std::chrono::steady_clock::now();
+
+    pass1.writeIntFile("/tmp/pass1_bench.int");
+    symtab.setProgramBlocks(&pass1.getProgramBlocks());
+    symtab.writeToFile("/tmp/pass1_bench.sym");
+    littab.writeToFile("/tmp/pass1_bench.lit");
+    IntermediateFile::write("/tmp/pass1_bench.bin", pass1, symtab, littab, pool);
+
+    Console::redirect(nullptr, nullptr);
+    artifacts = captured.str() + readAll("/tmp/pass1_bench.int") + readAll("/tmp/pass1_bench.sym") +
+                readAll("/tmp/pass1_bench.lit") + readAll("/tmp/pass1_bench.bin");
+    return std::chrono::duration<double>(t1 - t0).count();
+}
+
+int main(int argc, char **argv) {
+    std::string source = argc > 1 ? argv[1] : "/tmp/pass2_bench.asm";
+    if (readAll(source).empty()) {
+        std::cerr << "Cannot open " << source << " (run pass2_bench first or pass a source file)" << std::endl;
+        return 1;
+    }
+
+    std::string serialArtifacts;
+    double serial = 1e30;
+    for (int r = 0; r < 3; ++r) {
+        serial = std::min(serial, runPass1(source, nullptr, serialArtifacts));
+    }
+    std::cout << std::left << std::setw(12) << "serial" << std::fixed << std::setprecision(2) << serial * 1000
+              << " ms" << std::endl;
+
+    size_t hardware = std::max(1u, std::thread::hardware_concurrency());
+    for (size_t threads : {size_t(2), size_t(4), size_t(8), hardware}) {
+        ThreadPool workers(threads);
+        std::string artifacts;
+        double best = 1e30;
+        for (int r = 0; r < 3; ++r) {
+            best = std::min(best, runPass1(source, &workers, artifacts));
+        }
+        bool same = artifacts == serialArtifacts;
+        std::cout << std::left << std::setw(12) << (std::to_string(threads) + " threads") << std::fixed
+                  << std::setprecision(2) << best * 1000 << " ms  (x" << serial / best << ")  "
+                  << (same ? "identical" : "MISMATCH") << std::endl;
+        if (!same) {
+            return 1;
+        }
+    }
+    return 0;
+}
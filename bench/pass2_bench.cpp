@@ -0,0 +1,137 @@
+// Pass 2 병렬 인코딩 벤치마크 (스레드 수별 시간, 직렬 결과와 바이트 단위 비교)
+// 빌드: g++ -std=c++17 -O2 -pthread -o pass2_bench bench/pass2_bench.cpp $(ls src/*.cpp | grep -v main.cpp)
+// 실행: ./pass2_bench [소스파일] (생략하면 합성 소스 사용)
+#include "../include/assembler.h"
+#include <chrono>
+
+static std::string makeSource(int lines) {
+    std::string src = "BENCH    START   0\n";
+    for (int i = 0; i < lines; ++i) {
+        std::string label = "L" + std::to_string(i);
+        label.resize(9, ' ');
+        std::string target = "L" + std::to_string((i * 7) % lines);
+        switch (i % 16) {
+        case 0:
+            src += label + "+JSUB   " + target + "\n";
+            break;
+        case 1:
+            src += label + "LDA     " + "L" + std::to_string(i > 0 ? i - 1 : 0) + "\n";
+            break;
+        case 2:
+            src += label + "STA     " + "L" + std::to_string(i + 1 < lines ? i + 1 : i) + ",X\n";
+            break;
+        case 3:
+            src += label + "CLEAR   X\n";
+            break;
+        case 4:
+            src += label + "LDT     #4096\n";
+            break;
+        case 5:
+            src += label + "LDA     =C'EOF'\n";
+            break;
+        case 6:
+            src += label + "BYTE    X'F1A2'\n";
+            break;
+        case 7:
+            src += label + "WORD    " + target + "\n";
+            break;
+        case 8:
+            src += "         BASE    " + target + "\n" + label + "+LDB    #" + target + "\n";
+            break;
+        case 9:
+            src += label + "COMPR   A,S\n";
+            break;
+        case 10:
+            src += label + "BYTE    C'SICXE'\n";
+            break;
+        case 11:
+            src += label + "RSUB\n";
+            break;
+        case 12:
+            src += (i % 64 == 12 ? "         LTORG\n" : "") + label + "TIXR    T\n";
+            break;
+        case 13:
+            src += label + "J       @" + target + "\n";
+            break;
+        case 14:
+            src += label + "RESW    1\n";
+            break;
+        default:
+            src += (i % 128 == 15 ? "         NOBASE\n" : "") + label + "LDX     " + target + "\n";
+            break;
+        }
+    }
+    src += "         END     L0\n";
+    return src;
+}
+
+// 한 번 실행하고 오브젝트 파일과 콘솔 출력을 모은다
+static double runPass2(OPTAB &optab, SymbolPool &pool, SYMTAB &symtab, LITTAB &littab, Pass1 &pass1,
+                       ThreadPool *workers, std::string &object, std::string &console) {
+    std::ostringstream captured;
+    Console::redirect(&captured, &captured);
+
+    std::pmr::monotonic_buffer_resource arena;
+    Pass2 pass2(&optab, &symtab, &littab, &pool, pass1.getIntFile(), pass1.getStartAddress(),
+                pass1.getProgramLength(), pass1.getProgramName(), pass1.getProgramBlocks(), &arena, workers);
+    auto t0 = std::chrono::steady_clock::now();
+    pass2.execute();
+    auto t1 = std::chrono::steady_clock::now();
+    pass2.writeObjFile("/tmp/pass2_bench.obj");
+
+    Console::redirect(nullptr, nullptr);
+    console = captured.str();
+    SourceFile file;
+    object = file.open("/tmp/pass2_bench.obj") ? std::string(file.contents()) : std::string();
+    return std::chrono::duration<double>(t1 - t0).count();
+}
+
+int main(int argc, char **argv) {
+    std::string source = argc > 1 ? argv[1] : "/tmp/pass2_bench.asm";
+    if (argc <= 1) {
+        std::ofstream(source) << makeSource(400000);
+    }
+
+    OPTAB optab;
+    SymbolPool pool(&optab);
+    SYMTAB symtab(&pool);
+    LITTAB littab(&pool);
+    Pass1 pass1(&optab, &symtab, &littab, &pool);
+    {
+        std::ostringstream quiet;
+        Console::redirect(&quiet, &std::cerr);
+        bool ok = pass1.execute(source);
+        Console::redirect(nullptr, nullptr);
+        if (!ok) {
+            std::cerr << "Pass 1 failed" << std::endl;
+            return 1;
+        }
+    }
+    symtab.setProgramBlocks(&pass1.getProgramBlocks());
+
+    std::string serialObject, serialConsole;
+    double serial = 1e30;
+    for (int r = 0; r < 3; ++r) {
+        serial = std::min(serial, runPass2(optab, pool, symtab, littab, pass1, nullptr, serialObject, serialConsole));
+    }
+    std::cout << std::left << std::setw(12) << "serial" << std::fixed << std::setprecision(2) << serial * 1000
+              << " ms  (" << pass1.getIntFile().size() << " lines)" << std::endl;
+
+    size_t hardware = std::max(1u, std::thread::hardware_concurrency());
+    for (size_t threads : {size_t(2), size_t(4), size_t(8), hardware}) {
+        ThreadPool workers(threads);
+        std::string object, console;
+        double best = 1e30;
+        for (int r = 0; r < 3; ++r) {
+            best = std::min(best, runPass2(optab, pool, symtab, littab, pass1, &workers, object, console));
+        }
+        bool same = object == serialObject && console == serialConsole;
+        std::cout << std::left << std::setw(12) << (std::to_string(threads) + " threads") << std::fixed
+                  << std::setprecision(2) << best * 1000 << " ms  (x" << serial / best << ")  "
+                  << (same ? "identical" : "MISMATCH") << std::endl;
+        if (!same) {
+            return 1;
+        }
+    }
+    return 0;
+}
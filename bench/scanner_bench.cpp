@@ -0,0 +1,84 @@
+// SourceScanner 마이크로벤치마크
+// 빌드: g++ -std=c++17 -O2 -o scanner_bench bench/scanner_bench.cpp src/SourceScanner.cpp src/Parser.cpp src/Expression.cpp src/SYMTAB.cpp src/SymbolPool.cpp src/OPTAB.cpp src/SourceFile.cpp src/OutputBuffer.cpp src/Console.cpp
+// 실행: ./scanner_bench [소스파일] (생략하면 합성 소스 사용)
+#include "../include/assembler.h"
+#include <chrono>
+
+static std::string makeSource(int lines) {
+    static const char *ops[] = {"LDA", "STA", "LDX", "COMP", "JEQ", "STCH", "+JSUB", "CLEAR", "RESW", "BYTE"};
+    std::string src = "BENCH    START   0\n";
+    for (int i = 0; i < lines; ++i) {
+        std::string label = (i % 3 == 0) ? "L" + std::to_string(i) : "";
+        label.resize(9, ' ');
+        std::string op = ops[i % 10];
+        op.resize(8, ' ');
+        if (i % 50 == 0)
+            src += "# comment line " + std::to_string(i) + "\n";
+        src += label + op + "L" + std::to_string((i * 7) % lines) + ((i % 4 == 0) ? ",X" : "") + "\n";
+    }
+    src += "         END     L0\n";
+    return src;
+}
+
+template <typename F>
+static double bestOf(int runs, F body) {
+    double best = 1e30;
+    for (int r = 0; r < runs; ++r) {
+        auto t0 = std::chrono::steady_clock::now();
+        body();
+        auto t1 = std::chrono::steady_clock::now();
+        best = std::min(best, std::chrono::duration<double>(t1 - t0).count());
+    }
+    return best;
+}
+
+int main(int argc, char **argv) {
+    std::string synthetic;
+    SourceFile file;
+    std::string_view text;
+    if (argc > 1) {
+        if (!file.open(argv[1])) {
+            std::cerr << "Cannot open " << argv[1] << std::endl;
+            return 1;
+        }
+        text = file.contents();
+    } else {
+        synthetic = makeSource(1000000);
+        text = synthetic;
+    }
+    const int runs = 5;
+    double mb = text.size() / (1024.0 * 1024.0);
+    size_t checksum = 0;
+
+    // 기존 경로: 라인 단위 memchr + parseLine (find_first_not_of 기반)
+    double base = bestOf(runs, [&] {
+        size_t pos = 0;
+        std::string_view line;
+        while (pos < text.size()) {
+            size_t nl = text.find('\n', pos);
+            line = text.substr(pos, (nl == std::string_view::npos ? text.size() : nl) - pos);
+            pos = (nl == std::string_view::npos) ? text.size() : nl + 1;
+            SourceLine parsed = Parser::parseLine(line);
+            checksum += parsed.opcode.size() + parsed.operand.size();
+        }
+    });
+    std::cout << std::left << std::setw(12) << "parseLine" << std::fixed << std::setprecision(2)
+              << base * 1000 << " ms  " << mb / base << " MB/s" << std::endl;
+
+    std::pmr::vector<LineFields> lines;
+    for (SourceScanner::Isa isa : {SourceScanner::Isa::Scalar, SourceScanner::Isa::SSE2, SourceScanner::Isa::AVX2}) {
+        if (isa != SourceScanner::Isa::Scalar && static_cast<int>(isa) > static_cast<int>(SourceScanner::detect()))
+            continue;
+        double t = bestOf(runs, [&] {
+            SourceScanner::scan(text, lines, isa);
+            for (const LineFields &f : lines) {
+                SourceLine parsed = Parser::parseFields(text, f);
+                checksum += parsed.opcode.size() + parsed.operand.size();
+            }
+        });
+        std::cout << std::left << std::setw(12) << SourceScanner::isaName(isa) << std::fixed << std::setprecision(2)
+                  << t * 1000 << " ms  " << mb / t << " MB/s  (x" << base / t << ")" << std::endl;
+    }
+    std::cout << "lines: " << lines.size() << ", checksum: " << checksum << std::endl;
+    return 0;
+}
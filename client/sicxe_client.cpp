@@ -0,0 +1,110 @@
+// 상주 어셈블러 서버(--serve)용 클라이언트: 기존 CLI처럼 input/SRCFILE을 어셈블해 output/에 쓴다
+// 빌드: g++ -std=c++17 -O2 -o sicxe_client client/sicxe_client.cpp src/AssemblerProtocol.cpp
+// 실행: ./sicxe_client [--socket <경로>] [--source <파일>] [--output <디렉터리>] [--send-path] [--no-listing]
+//       ./sicxe_client --shutdown  (서버 종료)
+// 소켓 경로는 --socket, SICXE_ASSEMBLER_SOCKET 환경 변수, 기본 경로 순으로 정한다
+// 종료 코드: 0 성공, 1 어셈블 실패, 2 서버 연결/통신 실패
+#include "../include/assembler.h"
+#include <cstdlib>
+#include <unistd.h>
+
+static bool readFile(const std::string &filename, std::string &contents) {
+    std::ifstream file(filename, std::ios::binary);
+    if (!file) {
+        return false;
+    }
+    std::ostringstream buffer;
+    buffer << file.rdbuf();
+    contents = buffer.str();
+    return true;
+}
+
+static bool writeFile(const std::string &filename, const std::string &contents) {
+    std::ofstream file(filename, std::ios::binary);
+    file.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+    return static_cast<bool>(file);
+}
+
+int main(int argc, char *argv[]) {
+    const char *fromEnvironment = std::getenv("SICXE_ASSEMBLER_SOCKET");
+    std::string socketPath = fromEnvironment ? fromEnvironment : AssemblerProtocol::DEFAULT_SOCKET;
+    std::string source = "input/SRCFILE";
+    std::string outputDir = "output";
+    bool sendPath = false;
+    bool listing = true;
+    bool shutdown = false;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--socket" && i + 1 < argc) {
+            socketPath = argv[++i];
+        } else if (arg == "--source" && i + 1 < argc) {
+            source = argv[++i];
+        } else if (arg == "--output" && i + 1 < argc) {
+            outputDir = argv[++i];
+        } else if (arg == "--send-path") {
+            sendPath = true;
+        } else if (arg == "--no-listing") {
+            listing = false;
+        } else if (arg == "--shutdown") {
+            shutdown = true;
+        } else {
+            std::cerr << "Usage: " << argv[0]
+                      << " [--socket <path>] [--source <file>] [--output <dir>] [--send-path] [--no-listing]"
+                         " | --shutdown"
+                      << std::endl;
+            return 2;
+        }
+    }
+
+    AssembleRequest request{AssembleRequest::ASSEMBLE, 0, AssemblerProtocol::ARTIFACT_ALL, ""};
+    if (shutdown) {
+        request.command = AssembleRequest::SHUTDOWN;
+    } else if (sendPath) {
+        // 서버의 작업 디렉터리는 다르므로 절대 경로로 보낸다
+        char *resolved = realpath(source.c_str(), nullptr);
+        if (!resolved) {
+            std::cerr << "Error: Cannot open source file: " << source << std::endl;
+            return 1;
+        }
+        request.source = resolved;
+        request.flags = AssembleRequest::SOURCE_IS_PATH;
+        std::free(resolved);
+    } else if (!readFile(source, request.source)) {
+        std::cerr << "Error: Cannot open source file: " << source << std::endl;
+        return 1;
+    }
+    if (!listing) {
+        request.artifacts &= ~AssemblerProtocol::ARTIFACT_LISTING;
+    }
+
+    int fd = AssemblerProtocol::connectTo(socketPath);
+    if (fd < 0) {
+        std::cerr << "Error: Cannot connect to assembler server at " << socketPath
+                  << " (start one with --serve)" << std::endl;
+        return 2;
+    }
+    std::string message;
+    AssembleResponse response;
+    bool received = AssemblerProtocol::send(fd, AssemblerProtocol::encode(request)) &&
+                    AssemblerProtocol::receive(fd, message) && AssemblerProtocol::decode(message, response);
+    close(fd);
+    if (!received) {
+        std::cerr << "Error: No valid response from assembler server at " << socketPath << std::endl;
+        return 2;
+    }
+
+    std::cout << response.console;
+    std::cerr << response.diagnostics;
+    bool written = true;
+    for (const auto &artifact : response.artifacts) {
+        if (artifact.first == "LISTING") {
+            std::cout << artifact.second;
+        } else if (artifact.first.find('/') != std::string::npos) {
+            continue; // 출력 디렉터리 밖에는 쓰지 않는다
+        } else if (!writeFile(outputDir + "/" + artifact.first, artifact.second)) {
+            std::cerr << "Error: Cannot write " << outputDir << "/" << artifact.first << std::endl;
+            written = false;
+        }
+    }
+    return response.ok && written ? 0 : 1;
+}
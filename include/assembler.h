@@ -2,12 +2,24 @@
 #define ASSEMBLER_H
 
 #include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
 #include <fstream>
+#include <functional>
 #include <iomanip>
 #include <iostream>
 #include <map>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
 #include <sstream>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
 #include <vector>
 
 struct ProgramBlock {
@@ -18,193 +30,1207 @@ struct ProgramBlock {
     int currentLocctr;
 };
 
+// ==================== BlockTable ====================
+// 블록 번호를 인덱스로 쓰는 조밀한 블록 테이블 (이름 색인은 USE에서만 사용)
+class BlockTable {
+private:
+    std::vector<ProgramBlock> blocks;
+    std::unordered_map<std::string, int> numbers;
+
+public:
+    BlockTable();
+    int use(std::string_view name); // 없으면 새 블록 생성, 블록 번호 반환
+    ProgramBlock &operator[](int number);
+    const ProgramBlock &operator[](int number) const;
+    size_t size() const;
+    int absoluteAddress(int number, int offset) const;
+    int totalLength() const;
+};
+
+// ==================== OutputBuffer ====================
+// 산출물 파일을 메모리 버퍼에 만든 뒤 한 번에 기록 (16진 변환은 룩업 테이블)
+class OutputBuffer {
+private:
+    std::string data;
+
+    void appendField(const char *text, size_t length, size_t width, bool leftAlign, char fill);
+
+public:
+    explicit OutputBuffer(size_t capacity = 0);
+    void reserve(size_t capacity);
+
+    void append(std::string_view text);
+    void append(char c);
+    void appendRepeat(char c, size_t count);
+    // std::setw(width) + std::left 로 쓴 문자열과 같은 결과
+    void appendPadded(std::string_view text, size_t width, char fill = ' ');
+    // 정확히 digits 자리 (상위 자리는 버림, 앞을 0으로 채움)
+    void appendHexFixed(uint32_t value, int digits);
+    void appendHexBytes(const uint8_t *bytes, size_t count);
+    // std::hex/std::uppercase + setw(width) + 정렬/채움 문자로 int를 쓴 것과 같은 결과
+    void appendHexField(int value, size_t width, bool leftAlign, char fill);
+    void appendDecimalField(int value, size_t width, bool leftAlign, char fill);
+
+    std::string_view view() const;
+    size_t size() const;
+    void clear(); // 용량은 그대로 두고 내용만 비운다
+    // 같은 디렉터리의 임시 파일에 다 쓴 뒤 이름을 바꾼다 (실패하면 기존 파일은 그대로)
+    bool writeTo(const std::string &filename) const;
+    static bool writeFile(const std::string &filename, std::string_view data);
+};
+
+// ==================== BufferedFile ====================
+// 한꺼번에 들고 있기엔 큰 산출물용: OutputBuffer에 덧붙이다가 FLUSH_SIZE를 넘을 때마다 파일에 이어 쓴다
+// 쓰는 동안에는 같은 디렉터리의 임시 파일에 쓰고, close()가 성공해야 원래 이름으로 바꾼다
+class BufferedFile {
+private:
+    std::ofstream file;
+    OutputBuffer buffer;
+    std::string target;
+    std::string temporary;
+    bool ok;
+
+public:
+    static const size_t FLUSH_SIZE = 64 << 10;
+
+    BufferedFile();
+    // close()로 마치지 못했으면 임시 파일을 지운다 (기존 파일은 그대로)
+    ~BufferedFile();
+    BufferedFile(const BufferedFile &) = delete;
+    BufferedFile &operator=(const BufferedFile &) = delete;
+
+    bool open(const std::string &filename);
+    // 여기에 덧붙인 뒤 flushIfFull()을 부른다
+    OutputBuffer &out();
+    void flushIfFull();
+    // 남은 내용을 쓰고 닫은 뒤 이름을 바꾼다 (중간에 쓰기 오류가 있었으면 false)
+    bool close();
+};
+
+// ==================== Console ====================
+// 진행 메시지와 진단 메시지는 모두 여기를 거친다
+// 기본 출력은 버퍼 하나에 모았다가 stdout으로 내보내고 (std::endl마다 쓰지 않는다),
+// 진단 메시지는 앞에 모인 진행 메시지를 먼저 내보낸 뒤 stderr에 바로 쓴다
+// 배치 모드처럼 여러 어셈블리를 동시에 돌릴 때는 스레드마다 자기 스트림으로 돌린다 (돌린 스트림은 수준과 무관하게 모두 받는다)
+enum class LogLevel { SILENT, ERRORS, SUMMARY, VERBOSE };
+
+class Console {
+public:
+    static std::ostream &out();     // 요약: 단계, 완료, 파일 기록
+    static std::ostream &verbose(); // 자세히: BASE 변경, 블록 배치
+    static std::ostream &err();     // 오류와 경고
+    // 기본 출력의 수준 (기본값 VERBOSE), 꺼진 수준의 메시지는 포맷하지 않고 버린다
+    static void setLevel(LogLevel level);
+    static bool enabled(LogLevel level);
+    static bool parseLevel(std::string_view name, LogLevel &level);
+    // 호출한 스레드의 출력 대상만 바꾼다 (nullptr이면 기본 출력으로 되돌림)
+    static void redirect(std::ostream *out, std::ostream *err);
+    // 모아 둔 기본 출력을 내보낸다 (프로세스가 끝날 때는 자동)
+    static void flush();
+};
+
+// 범위 안에서만 호출한 스레드의 출력 대상을 바꾸고, 벗어날 때 (예외로 빠져도) 이전 대상으로 되돌린다
+// keepLevel이면 돌린 스트림에도 출력 수준을 적용한다 (나중에 기본 출력으로 그대로 옮길 메시지를 모을 때)
+class ConsoleRedirect {
+private:
+    std::ostream *previousOut;
+    std::ostream *previousErr;
+    bool previousKeepLevel;
+
+public:
+    ConsoleRedirect(std::ostream *out, std::ostream *err, bool keepLevel = false);
+    ~ConsoleRedirect();
+    ConsoleRedirect(const ConsoleRedirect &) = delete;
+    ConsoleRedirect &operator=(const ConsoleRedirect &) = delete;
+};
+
+// ==================== Emit ====================
+// 어떤 산출물을 만들지 (--emit), 리스팅은 콘솔에 찍는 리스팅과 오브젝트 프로그램
+struct Emit {
+    static const uint32_t OBJFILE = 1;
+    static const uint32_t INTFILE = 2;
+    static const uint32_t INTFILE_BIN = 4;
+    static const uint32_t SYMTAB = 8;
+    static const uint32_t LITTAB = 16;
+    static const uint32_t LISTING = 32;
+    static const uint32_t ALL = 63;
+
+    // 쉼표로 구분한 이름 목록 ("objfile,symtab", "all", "none")
+    static bool parse(std::string_view list, uint32_t &mask);
+};
+
+// ==================== ThreadPool ====================
+// 고정 개수 작업 스레드. run()은 [0, count) 인덱스를 나눠 처리하고 모두 끝날 때까지 기다린다
+// (호출한 스레드도 함께 일한다)
+class ThreadPool {
+private:
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+    const std::function<void(size_t)> *task;
+    size_t next;
+    size_t total;
+    size_t finished;
+    bool stopping;
+    std::exception_ptr failure; // 이번 run()에서 처음 난 예외
+
+    void workerLoop();
+    void runIndex(std::unique_lock<std::mutex> &lock, size_t index);
+
+public:
+    // threads: 호출 스레드를 포함한 전체 개수 (0이면 하드웨어 스레드 수)
+    explicit ThreadPool(size_t threads = 0);
+    ~ThreadPool();
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    size_t size() const;
+    // 작업에서 예외가 나도 모든 인덱스가 끝날 때까지 기다린 뒤 첫 예외를 호출 스레드에서 다시 던진다
+    void run(size_t count, const std::function<void(size_t)> &body);
+};
+
+// ==================== WorkStealingPool ====================
+// 크기가 제각각인 독립 작업용: 인덱스를 스레드별 큐에 나눠 담고, 자기 큐가 비면 다른 큐에서 훔쳐 온다
+// (스레드는 run() 동안만 만든다, 작업 하나가 파일 하나처럼 커서 생성 비용은 무시할 만하다)
+class WorkStealingPool {
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<size_t> items;
+    };
+    size_t threads;
+
+    static bool take(Queue &queue, size_t &index);
+
+public:
+    // threads: 호출 스레드를 포함한 전체 개수 (0이면 하드웨어 스레드 수)
+    explicit WorkStealingPool(size_t threads = 0);
+
+    size_t size() const;
+    // [0, count)를 처리하고 모두 끝날 때까지 기다린다 (각 큐는 앞 인덱스부터 꺼내므로 큰 작업을 앞에 둔다)
+    void run(size_t count, const std::function<void(size_t)> &body);
+};
+
+// ==================== ArtifactWriter ====================
+// 부가 산출물을 백그라운드 스레드 하나에서 포맷하고 쓴다 (Pass 2와 동시에 돌려 쓰기 지연을 임계 경로에서 뺀다)
+// 작업은 Pass 1 이후 더 바뀌지 않는 테이블을 읽기만 해야 한다 (Pass 2 병렬 인코딩과 같은 전제)
+// 작업의 진행/오류 메시지는 모아 두었다가 finish()에서 부른 스레드의 Console로 내보낸다
+class ArtifactWriter {
+private:
+    std::vector<std::function<bool()>> tasks; // 쓰기에 성공하면 true
+    std::thread thread;
+    std::ostringstream progress;
+    std::ostringstream errors;
+    bool ok;
+
+public:
+    ArtifactWriter();
+    // finish()를 부르지 않고 끝나도 (Pass 2 실패 등) 스레드를 합류시키고 메시지를 내보낸다
+    ~ArtifactWriter();
+    ArtifactWriter(const ArtifactWriter &) = delete;
+    ArtifactWriter &operator=(const ArtifactWriter &) = delete;
+
+    // start() 전에만 추가한다
+    void add(std::function<bool()> task);
+    void start();
+    // 모든 작업이 끝날 때까지 기다린다 (하나라도 실패했으면 false)
+    bool finish();
+};
+
 // ==================== OPTAB ====================
+// 식별자 인터닝 ID (SymbolPool 참고)
+typedef uint32_t SymbolId;
+const SymbolId NO_SYMBOL = 0xFFFFFFFFu;
+
 struct InstructionInfo {
-    std::string opcode;
-    int format;
+    uint8_t opcode; // opcode 바이트 (하위 2비트 0)
+    uint8_t format; // 1, 2, 3 (+ 접두사면 4)
 };
 
+// 표준 SIC/XE 명령어는 컴파일 타임 완전 해시 표로 내장, load()는 추가/재정의용
 class OPTAB {
 private:
-    std::map<std::string, InstructionInfo> table;
-    int determineFormat(const std::string &mnemonic);
+    std::vector<std::string_view> mnemonics; // 등록 순서 (SymbolPool의 ID와 같음)
+    std::vector<InstructionInfo> entries;    // mnemonics와 같은 인덱스
+    std::deque<std::string> extensionNames;  // 파일로 추가된 니모닉 저장소
+    std::map<std::string, size_t, std::less<>> extensions;
+    int determineFormat(std::string_view mnemonic) const;
+    int indexOf(std::string_view mnemonic) const;
 
 public:
     OPTAB();
     bool load(const std::string &filename);
-    bool isInstruction(const std::string &mnemonic) const;
-    std::string getOpcode(const std::string &mnemonic) const;
-    int getFormat(const std::string &mnemonic) const;
+    bool isInstruction(std::string_view mnemonic) const;
+    int getOpcode(std::string_view mnemonic) const;
+    int getFormat(std::string_view mnemonic) const;
+
+    // 이 OPTAB으로 초기화한 SymbolPool의 ID로 조회 (문자열 비교 없음)
+    bool isInstruction(SymbolId id) const;
+    int getOpcode(SymbolId id) const;
+    int getFormat(SymbolId id) const;
+
+    size_t size() const;
+    std::string_view getMnemonic(size_t index) const;
     void printTable() const;
 };
 
+// ==================== SymbolPool ====================
+// 라벨/니모닉/리터럴 등 식별자를 한 번만 저장하고 32비트 ID로 대응시킨다
+// SYMTAB, LITTAB, OPTAB, 중간파일이 같은 풀을 공유하므로 비교/조회는 정수 연산
+class SymbolPool {
+private:
+    std::pmr::deque<std::pmr::string> names; // ID로 인덱싱, 원소 주소가 바뀌지 않음
+    std::pmr::unordered_map<std::string_view, SymbolId> index;
+
+public:
+    explicit SymbolPool(std::pmr::memory_resource *memory = std::pmr::get_default_resource());
+    // OPTAB 니모닉을 먼저 등록 (ID == OPTAB 인덱스)
+    explicit SymbolPool(const OPTAB *optab, std::pmr::memory_resource *memory = std::pmr::get_default_resource());
+
+    SymbolId intern(std::string_view name);
+    SymbolId find(std::string_view name) const;
+    std::string_view name(SymbolId id) const;
+    size_t size() const;
+};
+
 // ==================== SYMTAB ====================
+struct SymbolEntry {
+    SymbolId id;
+    int address;
+    int blockNumber;
+};
+
+// 심볼 핸들: entries 인덱스 (재해시되어도 바뀌지 않음)
+typedef int32_t SymbolHandle;
+const SymbolHandle NO_HANDLE = -1;
+
+// SymbolId를 키로 하는 open addressing (선형 탐사) 해시 테이블
 class SYMTAB {
 private:
-    std::map<std::string, std::pair<int, int>> table;
-    const std::map<std::string, ProgramBlock> *programBlocks;
+    struct Slot {
+        SymbolId id; // NO_SYMBOL이면 빈 슬롯
+        uint32_t entry;
+    };
+
+    SymbolPool *pool;
+    std::pmr::vector<SymbolEntry> entries; // 삽입 순서
+    std::pmr::vector<Slot> slots;          // 크기는 2의 거듭제곱
+    const BlockTable *blocks;
+    size_t mask;
+
+    size_t slotOf(SymbolId symbol) const;
+    void rehash(size_t capacity);
+    std::vector<SymbolHandle> sortedSnapshot() const;
 
 public:
-    SYMTAB();
-    bool insert(const std::string &symbol, int address, int blockNum);
-    int lookup(const std::string &symbol) const;
-    int getBlockNumber(const std::string &symbol) const;
-    bool exists(const std::string &symbol) const;
+    explicit SYMTAB(SymbolPool *symbolPool, std::pmr::memory_resource *memory = std::pmr::get_default_resource());
+    bool insert(SymbolId symbol, int address, int blockNum);
+    // 마지막 항목을 지운 자리로 옮긴다 (그 항목의 핸들만 바뀐다)
+    bool erase(SymbolId symbol);
+
+    // 한 번의 탐사로 주소와 블록을 함께 얻는다
+    SymbolHandle find(SymbolId symbol) const;
+    const SymbolEntry &at(SymbolHandle handle) const;
+    size_t size() const;
 
-    std::vector<std::string> getAllSymbols() const;
-    void updateAddress(const std::string &symbol, int newAddress);
-    void setProgramBlocks(const std::map<std::string, ProgramBlock> *blocks);
+    int lookup(SymbolId symbol) const;
+    int getBlockNumber(SymbolId symbol) const;
+    bool exists(SymbolId symbol) const;
+    bool exists(std::string_view symbol) const;
+    int lookup(std::string_view symbol) const;
+
+    SymbolPool *getPool() const;
+    std::vector<SymbolId> getAllSymbols() const;
+    void updateAddress(SymbolId symbol, int newAddress);
+    void updateAddress(SymbolHandle handle, int newAddress);
+    void setProgramBlocks(const BlockTable *programBlocks);
     void print() const;
-    void writeToFile(const std::string &filename) const;
+    void format(OutputBuffer &out) const;
+    bool writeToFile(const std::string &filename) const;
 };
 
 // ==================== LITERAL ====================
 struct Literal {
-    std::string name;
-    std::string value;
+    SymbolId id;            // 리터럴 전체 ("=C'EOF'")
+    std::string_view value; // '=' 뒤 부분 (풀의 문자열을 가리킴)
     int address;
     int length;
     bool assigned;
 };
 
+// 리터럴 핸들: table 인덱스
+typedef int32_t LiteralHandle;
+const LiteralHandle NO_LITERAL = -1;
+
 class LITTAB {
 private:
-    std::vector<Literal> table;
+    SymbolPool *pool;
+    std::pmr::vector<Literal> table;                        // 삽입 순서
+    std::pmr::unordered_map<SymbolId, LiteralHandle> index; // SymbolId → table 인덱스
+    std::pmr::vector<LiteralHandle> pending;                // 마지막 LTORG/END 이후 추가된 리터럴
 
 public:
-    LITTAB();
-    void insert(const std::string &literal);
-    bool exists(const std::string &literal) const;
-    void assignAddress(const std::string &literal, int addr);
-    int getAddress(const std::string &literal) const;
-    int getLength(const std::string &literal) const;
-    std::string getValue(const std::string &literal) const;
+    explicit LITTAB(SymbolPool *symbolPool, std::pmr::memory_resource *memory = std::pmr::get_default_resource());
+    SymbolId insert(std::string_view literal);
+
+    // 한 번의 조회로 주소/길이/값을 함께 얻는다
+    LiteralHandle find(SymbolId literal) const;
+    const Literal &at(LiteralHandle handle) const;
+    void assignAddress(LiteralHandle handle, int addr);
+    // 현재 리터럴 풀을 넘겨주고 비운다 (LTORG/END)
+    std::pmr::vector<LiteralHandle> takePendingPool();
+    size_t size() const;
+
+    bool exists(SymbolId literal) const;
+    void assignAddress(SymbolId literal, int addr);
+    int getAddress(SymbolId literal) const;
+    int getLength(SymbolId literal) const;
+    std::string_view getValue(SymbolId literal) const;
     std::vector<Literal> getUnassignedLiterals() const;
     void print() const;
-    void writeToFile(const std::string &filename) const;
+    void format(OutputBuffer &out) const;
+    bool writeToFile(const std::string &filename) const;
+};
+
+// ==================== SourceFile ====================
+// 소스 파일 전체를 메모리 매핑하고 라인 단위로 순회 (라인 복사 없음)
+class SourceFile {
+private:
+    const char *data;
+    size_t size;
+    bool mapped;
+    std::string buffer; // mmap을 쓸 수 없을 때의 대체 버퍼
+
+    void release();
+
+public:
+    SourceFile();
+    ~SourceFile();
+    SourceFile(const SourceFile &) = delete;
+    SourceFile &operator=(const SourceFile &) = delete;
+
+    bool open(const std::string &filename);
+    std::string_view contents() const;
+    bool nextLine(size_t &pos, std::string_view &line) const;
+};
+
+// ==================== SourceScanner ====================
+enum LineFlags : uint8_t {
+    LINE_COMMENT = 1, // '#'으로 시작하는 주석 라인
+    LINE_BLANK = 2,   // 공백만 있는 라인
+    LINE_LABELED = 4  // 공백으로 시작하지 않음 (첫 단어가 라벨)
+};
+
+// 한 라인의 필드 경계 (소스 버퍼 기준 오프셋, 없는 단어는 end)
+struct LineFields {
+    uint32_t begin;       // 라인 시작
+    uint32_t end;         // 라인 끝 ('\n' 제외)
+    uint32_t token[3];    // 1~3번째 단어 시작
+    uint32_t tokenEnd[2]; // 1~2번째 단어 끝
+    uint32_t contentEnd;  // 마지막 공백이 아닌 문자 다음
+    uint8_t flags;
+};
+
+// 버퍼 전체의 개행/공백 위치를 SIMD로 한 번에 찾아 라인별 필드 경계를 만든다
+class SourceScanner {
+public:
+    enum class Isa { Scalar, SSE2, AVX2 };
+
+    static Isa detect();
+    static const char *isaName(Isa isa);
+    static bool scan(std::string_view buffer, std::pmr::vector<LineFields> &lines);
+    static bool scan(std::string_view buffer, std::pmr::vector<LineFields> &lines, Isa isa);
 };
 
 // ==================== Parser ====================
+// 소스 라인의 각 필드는 원본 버퍼를 가리키는 view (라인별 힙 할당 없음)
+// 원본 버퍼가 살아있는 동안만 유효
 struct SourceLine {
-    std::string label;
-    std::string opcode;
-    std::string operand;
+    std::string_view label;
+    std::string_view opcode;
+    std::string_view operand;
     bool isFormat4;
 };
 
 class Parser {
 public:
-    static SourceLine parseLine(const std::string &line);
-    static std::string trim(const std::string &str);
-    static bool startsWithWhitespace(const std::string &line);
-    static int evaluateExpression(const std::string &expr, SYMTAB *symtab);
+    static SourceLine parseLine(std::string_view line);
+    static SourceLine parseFields(std::string_view buffer, const LineFields &fields);
+    static std::string_view trim(std::string_view str);
+    static bool startsWithWhitespace(std::string_view line);
+    static int evaluateExpression(std::string_view expr, SYMTAB *symtab);
+    static bool parseNumber(std::string_view text, int base, int &value);
+};
+
+// ==================== Expression ====================
+// 후위 표기 바이트코드 명령
+struct ExprInstr {
+    enum Op : uint8_t { CONST, SYMBOL, LOCATION, ADD, SUB, MUL, DIV, NEG };
+    Op op;
+    int value; // CONST: 상수 값, SYMBOL: symbols 인덱스
+};
+
+// 한 번 컴파일해 두고 SYMTAB에 대해 여러 번 평가하는 표현식
+class CompiledExpression {
+private:
+    std::pmr::vector<ExprInstr> code;
+    std::pmr::vector<SymbolId> symbols;
+    int maxDepth;
+    bool valid;
+
+    friend class ExpressionCompiler;
+
+public:
+    // pmr 컨테이너 안에서 같은 메모리 자원을 쓰도록 allocator를 받는다
+    typedef std::pmr::polymorphic_allocator<std::byte> allocator_type;
+
+    explicit CompiledExpression(const allocator_type &alloc = allocator_type());
+    bool compile(std::string_view text, SymbolPool *pool);
+    bool isValid() const;
+    int evaluate(const SYMTAB *symtab, int location) const;
+};
 
+// 어셈블리 한 번 동안 같은 피연산자 문자열은 한 번만 컴파일
+class ExpressionCache {
 private:
-    static int parseOperand(const std::string &operand, SYMTAB *symtab);
+    std::pmr::deque<std::pmr::string> texts;
+    std::pmr::unordered_map<std::string_view, CompiledExpression> compiled;
+
+public:
+    explicit ExpressionCache(std::pmr::memory_resource *memory = std::pmr::get_default_resource());
+    const CompiledExpression &get(std::string_view text, SymbolPool *pool);
+    bool evaluate(std::string_view text, const SYMTAB *symtab, int location, int &value);
 };
 
 // ==================== Pass1 ====================
+// 라인 종류: Pass 1에서 한 번 분류하고 이후 단계는 switch로 분기
+enum class LineKind : uint8_t {
+    INSTRUCTION,
+    LITERAL, // LTORG/END가 만든 리터럴 라인
+    START,
+    END,
+    EQU,
+    ORG,
+    USE,
+    LTORG,
+    BASE,
+    NOBASE,
+    WORD,
+    BYTE,
+    RESW,
+    RESB,
+    UNKNOWN
+};
+
+// 중간 코드 한 줄 (IntermediateCode에 넣고 꺼낼 때 쓰는 값 타입)
 struct IntermediateLine {
+    LineKind kind;
     int location;
-    std::string label;
-    std::string opcode;
-    std::string operand;
-    std::string objcode;
+    SymbolId labelId;         // 라벨 없으면 NO_SYMBOL, 리터럴 라인은 "*"
+    SymbolId opcodeId;        // 니모닉/지시어 (리터럴 라인은 리터럴)
+    SymbolId operandId;       // 피연산자가 참조하는 심볼/리터럴 (없으면 NO_SYMBOL)
+    std::string_view operand; // 소스 버퍼를 가리킴
     bool hasLocation;
     bool isFormat4;
     int blockNumber;
 };
 
+// 소스 버퍼 (또는 extra 버퍼) 안의 구간
+struct TextSpan {
+    uint32_t offset; // 최상위 비트가 켜져 있으면 extra 버퍼
+    uint32_t length;
+};
+
+// 열 단위(SoA) 중간 코드: 필드별 배열에 라인을 나란히 저장하고 문자열은 구간만 보관
+class IntermediateCode {
+private:
+    friend class IntermediateFile;
+
+    static const uint32_t EXTRA_BIT = 0x80000000u;
+    static const uint8_t HAS_LOCATION = 1;
+    static const uint8_t FORMAT4 = 2;
+
+    std::string_view source;
+    std::pmr::string extra; // 소스 밖 문자열 (리터럴 값 등)
+
+    std::pmr::vector<LineKind> kinds;
+    std::pmr::vector<uint8_t> flags;
+    std::pmr::vector<int32_t> locations;
+    std::pmr::vector<int32_t> blockNumbers;
+    std::pmr::vector<SymbolId> labels;
+    std::pmr::vector<SymbolId> opcodes;
+    std::pmr::vector<SymbolId> operandRefs;
+    std::pmr::vector<TextSpan> operands;
+
+public:
+    // 심볼/리터럴을 정의한 줄 (태그 모드에서 미뤄 둔 이동을 주소에 더할 때 쓴다)
+    struct Definition {
+        uint64_t tag;
+        int32_t block;  // 정의되지 않았으면 -1
+        bool located;   // 줄의 위치가 값인지 (EQU는 아니다)
+    };
+
+private:
+    // 태그 모드 (증분 갱신): 줄마다 순서대로 커지는 태그를 붙여 두므로 줄을 끼우거나 지워도 다른 줄의 태그는
+    // 그대로다. 편집 뒤쪽의 위치 이동은 줄을 고쳐 쓰지 않고 블록마다 (태그, 누적 이동) 목록에 모아 두고 읽을 때 더한다
+    struct Shift {
+        uint64_t tag;  // 같은 블록에서 태그가 이 값 이상인 줄은
+        int32_t total; // 이만큼 움직였다 (앞 항목까지의 이동 포함)
+    };
+    static const uint64_t TAG_SPACING = 1ull << 32;  // 처음 붙이는 태그 간격
+    static const uint64_t MAX_TAG_STEP = 1ull << 20; // 끼운 줄 사이 간격 (뒤에 더 끼울 자리를 남긴다)
+
+    bool tagged;
+    std::pmr::vector<uint64_t> tags;
+    std::vector<std::vector<Shift>> shifts;       // 블록 번호 → 태그 순
+    std::vector<int32_t> startShifts;             // 블록 번호 → 시작 주소 이동 (절대 주소인 SYMTAB용)
+    bool shifted;                                 // 아직 반영하지 않은 이동이 있음
+    std::pmr::vector<Definition> definitions;     // SymbolId → 정의한 줄
+
+    TextSpan spanOf(std::string_view text);
+    std::string_view textOf(TextSpan span) const;
+    void append(const IntermediateLine &line, uint64_t tag);
+    bool movesWithBlock(size_t index) const;
+    int shiftAt(int block, uint64_t tag) const;
+
+public:
+    explicit IntermediateCode(std::pmr::memory_resource *memory = std::pmr::get_default_resource());
+    void setSource(std::string_view text);
+    void push(const IntermediateLine &line);
+    // [begin, begin + count)를 lines로 바꾼다 (새 줄의 문자열은 소스 밖이면 extra에 복사)
+    void replace(size_t begin, size_t count, const std::vector<IntermediateLine> &lines);
+    IntermediateLine at(size_t index) const;
+    size_t size() const;
+    bool empty() const;
+
+    LineKind kind(size_t index) const;
+    int location(size_t index) const;
+    int blockNumber(size_t index) const;
+    bool hasLocation(size_t index) const;
+
+    // 태그 모드 (push 전에 켠다)
+    void setTagged(bool enabled);
+    uint64_t tag(size_t index) const;
+    uint64_t nextTag() const;          // 다음 push가 붙일 태그
+    size_t indexOf(uint64_t tag) const; // 태그가 tag 이상인 첫 줄
+    // replace(begin, count, lines.size()개)에 쓸 태그 공간이 남았는지
+    bool canReplace(size_t begin, size_t count, size_t lines) const;
+    // from 줄부터 같은 블록 줄의 위치와 번호가 더 큰 블록의 시작 주소를 shift만큼 옮긴 것으로 기록
+    void shiftLocations(size_t from, int block, int shift, size_t blocks);
+    int locationShift(int block, uint64_t tag) const;
+    int symbolShift(SymbolId symbol, int block) const; // SYMTAB 주소에 더할 값
+    int literalShift(SymbolId literal) const;          // LITTAB 주소(블록 내 상대)에 더할 값
+    size_t pendingShifts() const;
+    // 미뤄 둔 이동을 위치 열에 반영하고 비운다 (SYMTAB/LITTAB 등 바깥 값은 부르는 쪽이 먼저 반영)
+    void settle();
+
+    void define(SymbolId symbol, uint64_t tag, int block, bool located);
+    void undefine(SymbolId symbol);
+    const Definition &definition(SymbolId symbol) const;
+};
+
+// 이전 소스와 비교해 바뀐 줄 범위 (IncrementalAssembler가 만든다)
+struct SourceEdit {
+    size_t firstLine;    // 처음 바뀐 줄
+    size_t removedLines; // 이전 소스에서 바뀐 줄 수
+    size_t beginByte;    // 바뀐 범위의 시작 (두 소스에서 같다)
+    size_t oldBytes;     // 이전 소스에서 바뀐 범위의 길이
+    size_t newBytes;     // 새 소스에서 바뀐 범위의 길이
+};
+
+// Pass1::update가 Pass2::update에 넘기는 변경 내용
+struct IntermediateEdit {
+    size_t begin; // 중간 코드 [begin, begin + inserted)가 새 줄 (이전 removed줄을 대신함)
+    size_t removed;
+    size_t inserted;
+    int block;        // 바뀐 범위의 블록
+    int location;     // 바뀐 범위가 시작하는 블록 내 위치
+    int shift;        // 범위 뒤 같은 블록 줄과 뒤 블록 전체가 움직인 양
+    bool baseChanged; // 바뀐 범위에 BASE/NOBASE가 있었음
+    std::vector<SymbolId> redefined; // 새로 정의되었거나 사라진 심볼
+    std::vector<std::pair<uint64_t, SymbolId>> released; // 지운 줄의 (태그, 피연산자 심볼)
+};
+
+class OnePassEncoder;
+
 class Pass1 {
 private:
-    OPTAB *optab;
+    const OPTAB *optab;
     SYMTAB *symtab;
     LITTAB *littab;
-    std::vector<IntermediateLine> intFile;
+    SymbolPool *pool;
+    std::pmr::memory_resource *memory; // 어셈블리 한 번 동안 쓰는 메모리 자원
+    SourceFile source;
+    ExpressionCache expressions;
+    IntermediateCode intFile;
     int locctr;
     int startAddr;
     std::string programName;
 
-    std::map<std::string, ProgramBlock> programBlocks;
-    std::string currentBlock;
-    int blockCounter;
+    BlockTable programBlocks;
+    int currentBlock; // 현재 블록 번호
+    SymbolId literalLabel;
+    std::vector<LineKind> directiveKinds; // SymbolId → 지시어 종류
+    ThreadPool *workers;                  // 없으면 준비 단계도 직렬
+    OnePassEncoder *encoder;              // 원패스 모드: 중간 코드 대신 인코더로 보낸다
+
+    // 증분 모드: 소스 줄마다 처리 직전의 상태를 기억해 두고 바뀐 줄부터 다시 처리한다
+    struct SourceState {
+        uint64_t tag;     // 이 줄 이후의 첫 중간 코드 줄 태그
+        int32_t location; // 그 줄처럼 미뤄 둔 이동을 더해 읽는다
+        int32_t block;
+    };
+    // 미뤄 둔 위치 이동 목록이 이보다 길어지면 한 번 반영한다 (읽을 때의 탐색 비용 제한)
+    static const size_t MAX_PENDING_SHIFTS = 64;
+    bool incremental;
+    std::pmr::vector<SourceState> sourceStates; // END 줄까지
+    size_t layoutLine;    // 마지막 START/EQU/ORG/표현식 RESW·RESB 줄 번호 (1부터, 없으면 0)
+    bool finished;        // END까지 처리함
+    bool duplicateSymbols;
+    bool rewound;         // ORG로 위치를 되돌린 적이 있음 (블록 안 위치가 줄 순서대로 커지지 않는다)
 
+    // 준비 단계 결과: 파싱/분류/길이는 라인마다 독립이라 여러 스레드에서 미리 계산한다
+    struct PreparedLine {
+        SourceLine fields;
+        SymbolId opcodeId; // 이미 등록된 니모닉/지시어 ID (아니면 NO_SYMBOL, 순서대로 인터닝)
+        LineKind kind;
+        int length; // UNKNOWN_LENGTH면 LOCCTR/SYMTAB이 필요하므로 순서대로 계산
+    };
+    static const int UNKNOWN_LENGTH = -1;
+    // 준비 단계 청크 하나의 최소 줄 수
+    static const size_t MIN_CHUNK_LINES = 4096;
+
+    LineKind classify(SymbolId opcodeId) const;
+    void prepareLine(std::string_view text, const LineFields &fields, PreparedLine &out) const;
+    SymbolId internOperand(std::string_view operand);
+    void emit(const IntermediateLine &line);
     void processLTORG();
-    int getInstructionLength(const std::string &mnemonic, const std::string &operand);
-    int getDirectiveLength(const std::string &directive, const std::string &operand, SYMTAB *symtab);
-    void initializeBlocks();
+    int getDirectiveLength(LineKind kind, std::string_view directive, std::string_view operand, SYMTAB *symtab);
+    static int getByteLength(std::string_view operand);
     void finalizeBlocks();
+    int stateLocation(const SourceState &state) const;
+    bool canUpdate(size_t firstLine, size_t removedLines, const std::pmr::vector<PreparedLine> &prepared) const;
 
 public:
-    Pass1(OPTAB *opt, SYMTAB *sym, LITTAB *lit);
+    Pass1(const OPTAB *opt, SYMTAB *sym, LITTAB *lit, SymbolPool *symbols,
+          std::pmr::memory_resource *memory = std::pmr::get_default_resource(),
+          ThreadPool *threads = nullptr);
+    void setEncoder(OnePassEncoder *target);
+    void setIncremental(bool enabled);
     bool execute(const std::string &srcFilename);
-    void writeIntFile(const std::string &intFilename);
+    // 이미 메모리에 있는 소스 (text는 중간 코드를 쓰는 동안 살아 있어야 한다)
+    bool executeSource(std::string_view text);
+    // 바뀐 줄만 다시 처리 (setIncremental(true)로 실행한 뒤, 할 수 없는 편집이면 false이고 상태는 그대로)
+    bool update(std::string_view text, const SourceEdit &edit, IntermediateEdit &out);
+    // update가 미뤄 둔 위치 이동을 중간 코드, SYMTAB, LITTAB에 반영 (산출물을 쓰기 전에)
+    void settle();
+    bool writeIntFile(const std::string &intFilename) const;
     void printIntFile() const;
 
     int getProgramLength() const;
     int getStartAddress() const;
     int getFinalLocctr() const;
-    const std::vector<IntermediateLine> &getIntFile() const;
+    const IntermediateCode &getIntFile() const;
     std::string getProgramName() const;
-    const std::map<std::string, ProgramBlock> &getProgramBlocks() const;
+    const BlockTable &getProgramBlocks() const;
+};
+
+// ==================== IntermediateFile ====================
+// Pass 1 결과(IR, SYMTAB, LITTAB, 블록, 식별자 풀)를 담는 버전 있는 이진 중간 파일
+// 같은 기계에서 Pass 1 결과를 캐시하는 용도이므로 기계 고유 바이트 순서를 그대로 쓴다
+class IntermediateFile {
+private:
+    SourceFile image; // mmap한 중간 파일 (IR의 소스 텍스트가 이 영역을 가리킴)
+    IntermediateCode code;
+    BlockTable blocks;
+    std::string programName;
+    int startAddr;
+    int programLength;
+
+    // 읽은 IR의 값이 모두 범위 안인지 (종류, 풀 ID, 블록 번호, 텍스트 구간)
+    bool validCode(size_t names) const;
+
+public:
+    static const uint32_t VERSION = 1;
+
+    explicit IntermediateFile(std::pmr::memory_resource *memory = std::pmr::get_default_resource());
+    static void encode(std::string &out, const Pass1 &pass1, const SYMTAB &symtab, const LITTAB &littab,
+                       const SymbolPool &pool);
+    static bool write(const std::string &filename, const Pass1 &pass1, const SYMTAB &symtab,
+                      const LITTAB &littab, const SymbolPool &pool);
+    // 사람이 읽는 텍스트 INTFILE (이진 파일에서 다시 만들 수 있다)
+    static void formatText(OutputBuffer &out, const IntermediateCode &code, const BlockTable &blocks,
+                           const SymbolPool &pool);
+    static bool writeText(const std::string &filename, const IntermediateCode &code,
+                          const BlockTable &blocks, const SymbolPool &pool);
+
+    // pool은 Pass 1과 같은 OPTAB으로 만든 빈 풀이어야 한다
+    bool load(const std::string &filename, SYMTAB *symtab, LITTAB *littab, SymbolPool *pool);
+    const IntermediateCode &getIntFile() const;
+    const BlockTable &getProgramBlocks() const;
+    std::string getProgramName() const;
+    int getStartAddress() const;
+    int getProgramLength() const;
 };
 
 // ==================== Pass2 ====================
+// 라이브러리 API가 돌려주는 구조화된 오브젝트 프로그램 (H, T, M, E 레코드)
+struct TextRecord {
+    int address;
+    std::vector<uint8_t> bytes; // 최대 30바이트
+};
+
+struct ModificationRecord {
+    int address;
+    int length; // 수정할 half-byte 수
+};
+
+struct ObjectProgram {
+    std::string name;
+    int startAddress;
+    int length;
+    std::vector<TextRecord> textRecords;
+    std::vector<ModificationRecord> modificationRecords;
+    int firstExecAddress;
+};
+
+// objectBytes 안의 오브젝트 코드 구간과 그 절대 주소
+struct ObjectSpan {
+    int address;
+    uint32_t offset;
+    uint32_t length;
+};
+
 class Pass2 {
 private:
-    OPTAB *optab;
+    friend class OnePassEncoder; // 인코더와 레코드 조립을 그대로 재사용
+
+    const OPTAB *optab;
     SYMTAB *symtab;
     LITTAB *littab;
-    std::vector<IntermediateLine> intFile;
+    SymbolPool *pool;
+    const IntermediateCode &intFile; // Pass1 소유, 복사하지 않음
     int startAddr;
     int programLength;
     std::string programName;
     int firstExecAddr;
     int baseRegister;
-    std::map<std::string, ProgramBlock> programBlocks;
+    const BlockTable &programBlocks; // Pass1 소유, 공유
+    ThreadPool *workers;             // 없으면 직렬 인코딩
+
+    // 병렬 인코딩 단위: 일정한 줄 수로 나누고, 첫 줄의 BASE 값은 사전 훑기에서 정해 둔다
+    struct EncodedChunk {
+        size_t begin; // [begin, end) 줄 범위
+        size_t end;
+        int baseRegister; // 청크 안의 BASE/NOBASE 줄을 만나면 바뀐다
+        std::vector<uint8_t> bytes; // lineCode의 offset은 이 버퍼 기준
+        std::vector<ModificationRecord> modifications;
+        OutputBuffer messages; // 진단 메시지를 모았다가 병합할 때 줄 순서대로 출력
+        // 청크 안의 BASE/NOBASE 줄과 그 줄 앞까지의 메시지 길이 (BASE 메시지를 제자리에 끼우도록)
+        std::vector<std::pair<size_t, size_t>> bases;
+        // 줄별 결과 ([begin, end)를 0부터): 평소에는 lineCode/lineModifications 안을 가리키고,
+        // 스트리밍 모드에서는 병합할 때까지만 쓰는 아래 벡터를 가리킨다
+        ObjectSpan *code;
+        uint8_t *modificationLengths;
+        std::vector<ObjectSpan> localCode;
+        std::vector<uint8_t> localModifications;
+    };
+    // 청크 하나의 최소 줄 수 (작은 프로그램은 직렬로 처리)
+    static const size_t MIN_CHUNK_LINES = 4096;
+    // 스트리밍 모드에서 한 번에 인코딩해 두는 청크 수 (스레드당)
+    static const size_t STREAM_WINDOW_PER_THREAD = 2;
+
+    // 오브젝트 코드는 바이트로 모아 두고 16진 텍스트는 출력할 때만 만든다
+    std::pmr::vector<uint8_t> objectBytes;
+    std::pmr::vector<ObjectSpan> lineCode;    // intFile과 같은 인덱스 (스트리밍 모드에서는 비어 있다)
+    std::pmr::vector<uint8_t> lineModifications; // 줄마다 수정 레코드 길이 (0이면 없음, 증분 갱신용)
+    std::pmr::vector<ObjectSpan> textRecords; // T 레코드마다 하나
+    std::pmr::vector<ModificationRecord> modificationRecords;
+    ObjectSpan currentText;
+
+    // 증분 갱신용 색인 (prepareUpdates 이후): 줄은 중간 코드 태그로 가리키므로 줄을 끼우거나 지워도 그대로다.
+    // 편집이 주소를 옮기면 (블록, 태그) 순서로 편집 지점 뒤쪽이 모두 같은 만큼 움직인다. 형식 3 줄은 자신, 대상,
+    // BASE 심볼이 편집을 사이에 둘 때만 바뀌는데, PC/BASE 상대 변위는 둘이 가까울 때만 쓰이므로 편집 근처에서 찾고
+    // 직접 주소는 대상이 움직이면 바뀌므로 대상 위치 순서로 정렬해 두고 편집 지점 뒤쪽만 꺼낸다.
+    // T 레코드는 자기 바이트를 objectBytes 안에 연속으로 갖고, 고친 레코드는 끝에 새로 붙인다 (옛 자리는 버림)
+    static const uint8_t WATCH_REMOTE = 1;   // 숫자/EQU/없는 심볼 대상, 0번 밖 블록의 리터럴: 주소가 움직이면 항상
+    static const uint8_t WATCH_CROSS = 2;    // 대상이나 BASE 심볼이 다른 블록: 편집이 블록 경계 근처일 때
+    static const uint8_t WATCH_DIRECT = 4;   // 직접 주소나 숫자 BASE 상대: 대상이 움직이면
+    static const uint8_t WATCH_ABSOLUTE = 8; // 대상의 절대 주소를 담는다 (형식 4, WORD, #심볼): 출력 전에 고친다
+    // 편집 근처 창: BASE 상대 변위 범위와 명령어 길이 여유
+    static const int NEAR_WINDOW = 4096 + 8;
+    struct DirectLine {
+        int32_t block;   // 대상이 놓인 블록
+        uint64_t target; // 대상 정의 줄의 태그
+        uint64_t line;
+        bool operator<(const DirectLine &other) const;
+    };
+    bool tracking;
+    std::pmr::unordered_multimap<SymbolId, uint64_t> references; // 피연산자 심볼/리터럴 → 코드 줄과 BASE 줄
+    std::pmr::vector<uint64_t> baseLines;         // BASE/NOBASE 줄
+    std::pmr::vector<uint64_t> remoteLines;
+    std::pmr::vector<uint64_t> crossLines;
+    std::pmr::vector<uint64_t> absoluteLines;
+    std::pmr::vector<DirectLine> directLines;     // (블록, 대상 태그) 순서
+    std::pmr::unordered_map<uint64_t, DirectLine> directTargets; // 줄 → directLines 항목
+    std::pmr::vector<uint64_t> recordLines;       // textRecords마다 첫 줄
+    std::pmr::vector<uint64_t> modificationLines; // modificationRecords마다 그 줄
+    size_t garbageBytes;                          // objectBytes 안에서 더 이상 가리키지 않는 바이트
+    bool unsettled;                               // 편집 뒤 레코드 주소/절대 주소 필드를 아직 고치지 않음
 
     std::string headerRecord;
-    std::vector<std::string> textRecords;
-    std::vector<std::string> modificationRecords;
     std::string endRecord;
 
-    std::string currentTextRecord;
-    int currentTextRecordStartAddr;
-    int currentTextRecordLength;
-
-    std::string currentBlockName;
-    int currentBlockStartAddr;
+    // 스트리밍 모드: T 레코드를 만드는 대로 쓰고, 이미 쓴 바이트는 병합마다 objectBytes에서 버린다
+    std::unique_ptr<BufferedFile> stream;
+    std::string streamFilename;
 
-    std::map<std::string, int> registers;
+    std::pmr::map<std::string, int, std::less<>> registers; // string_view로 찾는다
 
     // 🔧 헬퍼 함수 추가
     int getAbsoluteAddress(int blockNum, int offset) const;
 
-    std::string generateObjectCode(IntermediateLine &line, int nextLoc);
-    std::string handleFormat1(const IntermediateLine &line);
-    std::string handleFormat2(const IntermediateLine &line);
-    std::string handleFormat3(const IntermediateLine &line, int nextLoc);
-    std::string handleFormat4(const IntermediateLine &line);
-    std::string handleDirective(const IntermediateLine &line);
+    // 인코더: 공유 테이블은 읽기만 하고 결과는 청크에 덧붙인다 (여러 스레드에서 동시에 호출)
+    void bindChunk(EncodedChunk &chunk);
+    void encodeChunk(EncodedChunk &chunk);
+    int nextLocation(size_t index, const IntermediateLine &line) const;
+    void generateObjectCode(const IntermediateLine &line, int nextLoc, EncodedChunk &out) const;
+    void handleFormat1(const IntermediateLine &line, EncodedChunk &out) const;
+    void handleFormat2(const IntermediateLine &line, EncodedChunk &out) const;
+    void handleFormat3(const IntermediateLine &line, int nextLoc, EncodedChunk &out) const;
+    void handleFormat4(const IntermediateLine &line, EncodedChunk &out) const;
+    void handleDirective(const IntermediateLine &line, EncodedChunk &out) const;
+    void handleLiteral(const IntermediateLine &line, EncodedChunk &out) const;
+    void emitBytes(EncodedChunk &out, uint32_t value, int count) const;
+    void emitHexString(EncodedChunk &out, std::string_view hex) const;
+
+    bool resolveBase(const IntermediateLine &line, int &base) const;
+    void announceBase(const IntermediateLine &line);
+    void printMessages(EncodedChunk &chunk);
+    void mergeChunk(EncodedChunk &chunk);
+    int symbolAddress(SymbolHandle symbol) const;
+    int literalAddress(SymbolId literal) const;
+    size_t baseLineAt(size_t index, int &base) const;
+    uint8_t watchFlags(size_t index, const IntermediateLine &line, DirectLine &direct) const;
+    void watchDirect(uint64_t line, const DirectLine *direct);
+    void trackLine(size_t index, const IntermediateLine &line);
+    void addGovernedLines(size_t baseLine, std::vector<std::pair<size_t, bool>> &candidates) const;
+    bool reencode(size_t index, bool force, EncodedChunk &scratch);
+    void patchTextRecords(size_t begin, size_t regionEnd);
+    void compactObjectBytes();
 
     void startNewTextRecord(int loc);
-    void appendToTextRecord(const std::string &objCode, int loc);
+    void appendToTextRecord(const ObjectSpan &code);
     void flushTextRecord();
+    void compactStreamedBytes();
+    bool finishStream();
+    void makeHeaderRecord();
+    void makeEndRecord(const IntermediateLine &end);
 
+    bool holdsObjectCode(const char *operation) const;
     std::string intToHex(int val, int width) const;
-    int hexStringToInt(const std::string &hexStr) const;
-    int getRegisterNum(const std::string &reg) const;
-    void addModificationRecord(int address, int length);
+    std::string bytesToHex(const ObjectSpan &code) const;
+    int getRegisterNum(std::string_view reg, OutputBuffer &messages) const;
 
 public:
-    Pass2(OPTAB *opt, SYMTAB *sym, LITTAB *lit,
-          const std::vector<IntermediateLine> &intF,
+    Pass2(const OPTAB *opt, SYMTAB *sym, LITTAB *lit, SymbolPool *symbols,
+          const IntermediateCode &intF,
           int start, int length, const std::string &progName,
-          const std::map<std::string, ProgramBlock> &blocks);
+          const BlockTable &blocks,
+          std::pmr::memory_resource *memory = std::pmr::get_default_resource(),
+          ThreadPool *threads = nullptr);
+    // execute() 전에 부르면 OBJFILE을 Pass 2 도중에 레코드 단위로 쓴다 (H는 먼저, T는 만드는 대로, M과 E는 끝에)
+    // 오브젝트 코드를 끝까지 들고 있지 않으므로 이후 리스팅/레코드 출력/exportProgram/update는
+    // 오류를 알리고 false(update는 0)를 돌려준다
+    bool streamTo(const std::string &objFilename);
     bool execute();
+    // execute() 뒤, 첫 Pass1::update 전에: 증분 갱신에 쓸 색인을 만든다
+    void prepareUpdates();
+    // Pass1::update 이후: 입력이 바뀐 줄만 다시 인코딩하고 바뀐 레코드만 고친다 (인코딩한 줄 수 반환)
+    size_t update(const IntermediateEdit &edit, int length);
+    // Pass1::settle 이후, 출력 전에: 미뤄 둔 레코드 주소와 절대 주소 필드를 고친다
+    void settle();
+    // 파일/콘솔 대신 버퍼로 (데몬 응답 등)
+    bool formatObjectProgram(OutputBuffer &out) const;
+    bool exportProgram(ObjectProgram &program) const;
+    bool writeObjFile(const std::string &objFilename) const;
+    bool printObjFile() const;
+    bool printListingFile() const;
+};
+
+// ==================== OnePassEncoder ====================
+// 원패스(load-and-go) 모드: Pass 1이 만든 줄을 받자마자 인코딩하고,
+// 아직 정의되지 않은 심볼/리터럴을 쓰는 줄은 ID별 fixup 체인에 걸어 두었다가 정의되는 순간 바이트를 고친다.
+// 기본 블록의 심볼은 START 이후 바로 절대 주소가 정해지고, 다른 블록은 END의 블록 배치 후에 정해진다.
+class OnePassEncoder {
+private:
+    // 줄마다 오브젝트 코드 위치 (절대 주소는 END에서 블록 배치 후 계산)
+    struct EmittedLine {
+        int blockNumber;
+        int location;
+        uint32_t offset;
+        uint32_t length;
+        ModificationRecord modification; // length가 0이면 없음
+        bool flush;                      // USE: 텍스트 레코드를 끊는다
+    };
+    // 피연산자 심볼이 아직 정의되지 않은 BASE
+    struct PendingBase {
+        IntermediateLine line;
+        int32_t previous;  // 직전 BASE도 pending이면 그 인덱스
+        int previousValue; // 아니면 직전 BASE 값 (피연산자가 잘못되면 그대로 유지)
+    };
+    struct BaseState {
+        int value;
+        int32_t pending; // pendingBases 인덱스 (-1이면 value가 확정 값)
+    };
+    // 아직 인코딩하지 못한 줄 (자리만 0으로 채워 둔다)
+    struct Fixup {
+        IntermediateLine line;
+        int nextLoc;
+        BaseState base;
+        uint32_t emitted; // EmittedLine 인덱스
+        int32_t next;     // 같은 ID를 기다리는 다음 fixup (-1이면 끝)
+        bool done;
+    };
+    // 블록 배치(END)를 기다리는 fixup은 체인에 걸지 않고 END에서 한꺼번에 처리
+    static const SymbolId WAIT_LAYOUT = NO_SYMBOL - 1;
+
+    const OPTAB *optab;
+    const SYMTAB *symbols; // Pass 1의 SYMTAB (END 전에는 블록 내 상대 주소)
+    LITTAB *littab;
+    SYMTAB resolved;       // 절대 주소가 정해진 심볼 (인코더는 이것만 본다)
+    BlockTable blocks;     // END 전에는 기본 블록 시작 주소만 유효
+    IntermediateCode none; // 원패스 모드에서는 중간 코드를 만들지 않는다
+    Pass2 encoder;
+    Pass2::EncodedChunk scratch;
+
+    std::pmr::vector<EmittedLine> emitted;
+    std::pmr::vector<Fixup> fixups;
+    std::pmr::unordered_map<SymbolId, int32_t> chains; // 기다리는 ID → 첫 fixup
+    std::pmr::vector<PendingBase> pendingBases;
+    BaseState base;
+
+    // Pass2와 같은 nextLoc을 쓰기 위해 코드 줄 하나를 다음 줄이 올 때까지 붙잡아 둔다
+    IntermediateLine lookahead;
+    bool hasLookahead;
+    IntermediateLine endLine;
+    bool started;
+    bool restarted;
+    bool ended;
+    bool layoutKnown;
+    int startAddr;
+
+    SymbolId blocker(const IntermediateLine &line, const BaseState &state) const;
+    int baseValue(const BaseState &state) const;
+    int resolvePending(int32_t index) const;
+    void encode(const IntermediateLine &line, int nextLoc, const BaseState &state);
+    void place(const IntermediateLine &line, int nextLoc);
+    void link(int32_t fixup, SymbolId id);
+    void resolveFixup(int32_t fixup);
+    void wake(SymbolId id);
+    void define(SymbolId id);
+
+public:
+    OnePassEncoder(const OPTAB *opt, SYMTAB *sym, LITTAB *lit, SymbolPool *pool,
+                   std::pmr::memory_resource *memory = std::pmr::get_default_resource());
+    void line(const IntermediateLine &line); // Pass 1이 중간 코드 대신 넘겨 준다
+    // END 이후: 남은 fixup을 처리하고 레코드를 조립 (START가 여럿이거나 END가 없으면 false)
+    bool finish(const Pass1 &pass1);
     void writeObjFile(const std::string &objFilename) const;
     void printObjFile() const;
-    void printListingFile() const;
+};
+
+// ==================== IncrementalAssembler ====================
+// 이전 실행의 소스, 테이블, 중간 코드, 오브젝트 코드를 메모리에 두고 다음 실행에서는 바뀐 줄만 처리한다
+// (위치를 바꾸는 지시어를 고친 경우처럼 증분으로 처리할 수 없으면 전체를 다시 어셈블)
+// 뒤쪽 줄의 위치 이동은 블록별로 미뤄 두고, 다시 인코딩할 줄은 심볼 참조 색인과 편집 근처에서 찾으며,
+// T/M 레코드는 바뀐 것만 고친다. 미뤄 둔 이동은 산출물을 쓸 때 한 번에 반영한다
+class IncrementalAssembler {
+private:
+    // 전체 어셈블리 한 번의 상태: 편집마다 고쳐 쓰므로 아레나 대신 기본 메모리 자원을 쓴다
+    struct Session {
+        SymbolPool pool;
+        SYMTAB symtab;
+        LITTAB littab;
+        Pass1 pass1;
+        std::unique_ptr<Pass2> pass2;
+
+        Session(const OPTAB *optab, ThreadPool *workers);
+    };
+
+    const OPTAB *optab;
+    ThreadPool *workers;
+    std::string base;     // 마지막으로 전체 어셈블한 소스 (중간 코드가 가리킨다)
+    std::string previous; // 마지막으로 처리한 소스 (다음 편집과 비교)
+    std::unique_ptr<Session> session;
+    uint32_t dirty; // 마지막으로 쓴 뒤 바뀐 산출물 (Emit 비트)
+
+    bool rebuild();
+    static bool diff(std::string_view before, std::string_view after, SourceEdit &edit);
+
+public:
+    explicit IncrementalAssembler(const OPTAB *opt, ThreadPool *threads = nullptr);
+    // 소스 파일을 다시 읽어 어셈블 (바뀐 것이 없으면 아무것도 하지 않는다)
+    bool assemble(const std::string &srcFilename);
+    // artifacts: Emit 비트 (LISTING은 콘솔에 찍는다). 미뤄 둔 이동을 반영하고 바뀐 산출물만 쓴다
+    void writeOutputs(uint32_t artifacts = Emit::ALL);
+};
+
+// ==================== BatchAssembler ====================
+// 여러 소스 파일을 한 프로세스에서 동시에 어셈블 (OPTAB은 한 번 만들어 모든 작업이 읽기 전용으로 공유)
+// 작업마다 자기 아레나와 SymbolPool/SYMTAB/LITTAB/Pass1/Pass2를 쓰고 산출물은 작업별 디렉터리에 쓴다
+struct BatchJob {
+    std::string source;
+    std::string outputDir;
+    bool ok;
+    size_t lines;
+    size_t errors; // "Error"로 시작하는 진단 메시지 수
+    double seconds;
+};
+
+class BatchAssembler {
+private:
+    const OPTAB *optab;
+    uint32_t artifacts; // Emit 비트 (LOG.txt는 항상 쓴다)
+    std::vector<BatchJob> jobs;
+
+    void assembleJob(BatchJob &job) const;
+
+public:
+    explicit BatchAssembler(const OPTAB *opt, uint32_t emit = Emit::ALL);
+    // 출력 디렉터리를 생략하면 output/<소스 파일 이름에서 확장자를 뺀 것>
+    void add(const std::string &source, const std::string &outputDir = "");
+    // 한 줄에 "소스 [출력 디렉터리]" (빈 줄과 #으로 시작하는 줄은 무시)
+    bool addManifest(const std::string &filename);
+    size_t size() const;
+    // 모든 작업을 처리하고 파일별 결과와 전체 처리량을 출력 (실패한 작업 수를 돌려준다)
+    size_t run(size_t threads = 0);
+};
+
+// ==================== Assembler ====================
+// 라이브러리 API: 메모리의 소스를 어셈블해 구조화된 결과를 돌려준다
+// 요청하지 않으면 파일도 콘솔도 쓰지 않는다 (진행 메시지는 버리고 진단 메시지는 결과에 담는다)
+struct AssemblyOptions {
+    bool objectText;   // OBJFILE 텍스트
+    bool listing;      // 리스팅 텍스트 (Pass2::printListingFile과 같은 내용)
+    bool intermediate; // 텍스트 INTFILE
+    std::ostream *log; // 진행 메시지를 받을 곳 (nullptr이면 버린다)
+    ThreadPool *workers; // 큰 프로그램을 여러 스레드로 (nullptr이면 직렬)
+    const OPTAB *optab;  // nullptr이면 내장 명령어 집합
+
+    AssemblyOptions()
+        : objectText(false), listing(false), intermediate(false), log(nullptr), workers(nullptr), optab(nullptr) {}
+};
+
+struct Diagnostic {
+    enum Severity { ERROR, WARNING, NOTE };
+    Severity severity;
+    std::string message;
+};
+
+struct SymbolInfo {
+    std::string name;
+    int address; // 절대 주소
+    int block;
+};
+
+struct LiteralInfo {
+    std::string name; // "=C'EOF'"
+    std::string value;
+    int address; // LITTAB.txt와 같은 값 (블록 내 주소)
+    int length;
+    bool assigned;
+};
+
+struct AssemblyResult {
+    bool ok;
+    ObjectProgram program;
+    std::vector<SymbolInfo> symbols;   // 이름 순
+    std::vector<LiteralInfo> literals; // 등록 순
+    std::vector<Diagnostic> diagnostics;
+    std::string objectText;
+    std::string listing;
+    std::string intermediate;
+};
+
+class Assembler {
+public:
+    static AssemblyResult assemble(std::string_view source, const AssemblyOptions &options = AssemblyOptions());
+};
+
+// ==================== AssemblerProtocol ====================
+// --serve 데몬과 클라이언트 사이의 메시지 (같은 기계의 Unix 소켓이므로 정수는 기계 고유 바이트 순서)
+//   메시지: u32 길이 | 본문
+//   요청  : "SXRQ" | version | command | flags | artifacts | source
+//   응답  : "SXRS" | version | ok | console | diagnostics | 개수 | (이름, 내용)...
+// 문자열은 u32 길이 + 바이트
+struct AssembleRequest {
+    enum Command : uint32_t { ASSEMBLE = 0, SHUTDOWN = 1 };
+    static const uint32_t SOURCE_IS_PATH = 1; // source가 내용이 아니라 서버가 읽을 경로
+
+    Command command;
+    uint32_t flags;
+    uint32_t artifacts; // 돌려받을 산출물 (AssemblerProtocol::ARTIFACT_*)
+    std::string source;
+};
+
+struct AssembleResponse {
+    bool ok;
+    std::string console;     // main이 stdout에 찍던 진행 메시지
+    std::string diagnostics; // 오류/경고 (stderr)
+    std::vector<std::pair<std::string, std::string>> artifacts; // 파일 이름과 내용
+};
+
+class AssemblerProtocol {
+public:
+    static const uint32_t VERSION = 1;
+    static const uint32_t MAX_MESSAGE_SIZE = 256u << 20;
+    static const char *const DEFAULT_SOCKET;
+
+    static const uint32_t ARTIFACT_OBJFILE = 1;
+    static const uint32_t ARTIFACT_INTFILE = 2;     // 텍스트 INTFILE과 INTFILE.bin
+    static const uint32_t ARTIFACT_TABLES = 4;      // SYMTAB.txt, LITTAB.txt
+    static const uint32_t ARTIFACT_LISTING = 8;     // 리스팅과 오브젝트 프로그램 (main이 마지막에 찍던 것)
+    static const uint32_t ARTIFACT_ALL = 15;
+
+    static std::string encode(const AssembleRequest &request);
+    static std::string encode(const AssembleResponse &response);
+    static bool decode(std::string_view message, AssembleRequest &request);
+    static bool decode(std::string_view message, AssembleResponse &response);
+
+    // 길이를 붙여 메시지 하나를 보내고 받는다 (끊기거나 너무 크면 false)
+    static bool send(int fd, const std::string &message);
+    static bool receive(int fd, std::string &message);
+    // 서버 소켓에 연결 (실패하면 -1)
+    static int connectTo(const std::string &socketPath);
+};
+
+// ==================== AssemblerServer ====================
+// OPTAB을 한 번만 준비해 두고 Unix 소켓으로 어셈블 요청을 받는 상주 프로세스
+// 작업 스레드마다 accept()로 연결을 하나씩 받아 요청마다 새 테이블로 Pass 1/Pass 2를 돌린다
+class AssemblerServer {
+private:
+    const OPTAB *optab;
+    std::string socketPath;
+    size_t threads;
+    int listener;
+    std::atomic<bool> stopping;
+
+    void serve();
+    void handle(int client);
+    AssembleResponse assemble(const AssembleRequest &request) const;
+
+public:
+    AssemblerServer(const OPTAB *opt, const std::string &path, size_t threads = 0);
+    ~AssemblerServer();
+    AssemblerServer(const AssemblerServer &) = delete;
+    AssemblerServer &operator=(const AssemblerServer &) = delete;
+
+    // 소켓을 만들고 listen (같은 경로에 이미 서버가 떠 있으면 false)
+    bool start();
+    // SHUTDOWN 요청을 받을 때까지 요청을 처리
+    void run();
 };
 
 #endif
\ No newline at end of file
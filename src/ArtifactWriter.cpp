@@ -0,0 +1,40 @@
+#include "../include/assembler.h"
+
+ArtifactWriter::ArtifactWriter() : ok(true) {}
+
+ArtifactWriter::~ArtifactWriter() {
+    finish();
+}
+
+void ArtifactWriter::add(std::function<bool()> task) {
+    tasks.push_back(std::move(task));
+}
+
+void ArtifactWriter::start() {
+    thread = std::thread([this]() {
+        // 이 스레드의 메시지는 모아 두었다가 finish()에서 한꺼번에 (main 스레드 출력과 섞이지 않도록)
+        Console::redirect(&progress, &errors);
+        for (const std::function<bool()> &task : tasks) {
+            try {
+                if (!task()) {
+                    ok = false;
+                }
+            } catch (const std::exception &e) {
+                Console::err() << "Error: " << e.what() << std::endl;
+                ok = false;
+            }
+        }
+        Console::redirect(nullptr, nullptr);
+    });
+}
+
+bool ArtifactWriter::finish() {
+    if (thread.joinable()) {
+        thread.join();
+        Console::out() << progress.str();
+        Console::err() << errors.str();
+        progress.str("");
+        errors.str("");
+    }
+    return ok;
+}
@@ -0,0 +1,95 @@
+#include "../include/assembler.h"
+
+// 아레나 첫 블록 크기 (작은 모듈을 여러 번 어셈블하는 경우가 많으므로 main보다 작게)
+static const size_t ARENA_INITIAL_SIZE = 64 << 10;
+
+// 모은 진단 메시지를 줄 단위로 나눠 심각도를 붙인다
+static void collectDiagnostics(const std::string &messages, std::vector<Diagnostic> &out) {
+    std::istringstream lines(messages);
+    std::string line;
+    while (std::getline(lines, line)) {
+        if (line.empty()) {
+            continue;
+        }
+        Diagnostic::Severity severity = Diagnostic::NOTE;
+        if (line.compare(0, 5, "Error") == 0) {
+            severity = Diagnostic::ERROR;
+        } else if (line.compare(0, 7, "Warning") == 0) {
+            severity = Diagnostic::WARNING;
+        }
+        out.push_back(Diagnostic{severity, line});
+    }
+}
+
+AssemblyResult Assembler::assemble(std::string_view source, const AssemblyOptions &options) {
+    AssemblyResult result;
+    result.ok = false;
+    result.program = ObjectProgram{"", 0, 0, {}, {}, 0};
+
+    // 버퍼가 없는 스트림은 출력 연산이 바로 실패하므로 진행 메시지를 만드는 비용이 거의 없다
+    std::ostream discard(nullptr);
+    std::ostringstream diagnostics;
+    // 호출한 쪽이 돌려 둔 출력 대상은 어느 경로로 끝나든 되돌린다 (바깥 assemble, 서버 등)
+    ConsoleRedirect redirect(options.log ? options.log : &discard, &diagnostics);
+
+    try {
+        static const OPTAB builtin;
+        const OPTAB *optab = options.optab ? options.optab : &builtin;
+        std::pmr::monotonic_buffer_resource arena(ARENA_INITIAL_SIZE);
+        SymbolPool pool(optab, &arena);
+        SYMTAB symtab(&pool, &arena);
+        LITTAB littab(&pool, &arena);
+        Pass1 pass1(optab, &symtab, &littab, &pool, &arena, options.workers);
+        if (pass1.executeSource(source)) {
+            symtab.setProgramBlocks(&pass1.getProgramBlocks());
+            if (options.intermediate) {
+                OutputBuffer out;
+                IntermediateFile::formatText(out, pass1.getIntFile(), pass1.getProgramBlocks(), pool);
+                result.intermediate.assign(out.view());
+            }
+
+            Pass2 pass2(optab, &symtab, &littab, &pool, pass1.getIntFile(), pass1.getStartAddress(),
+                        pass1.getProgramLength(), pass1.getProgramName(), pass1.getProgramBlocks(), &arena,
+                        options.workers);
+            if (pass2.execute()) {
+                pass2.exportProgram(result.program);
+                if (options.objectText) {
+                    OutputBuffer out;
+                    pass2.formatObjectProgram(out);
+                    result.objectText.assign(out.view());
+                }
+                if (options.listing) {
+                    std::ostringstream listing;
+                    {
+                        ConsoleRedirect toListing(&listing, &diagnostics);
+                        pass2.printListingFile();
+                    }
+                    result.listing = listing.str();
+                }
+                result.ok = true;
+            }
+
+            // 테이블은 아레나와 풀이 사라지기 전에 복사한다
+            result.symbols.reserve(symtab.size());
+            for (size_t handle = 0; handle < symtab.size(); ++handle) {
+                const SymbolEntry &entry = symtab.at(static_cast<SymbolHandle>(handle));
+                result.symbols.push_back(
+                    SymbolInfo{std::string(pool.name(entry.id)), entry.address, entry.blockNumber});
+            }
+            std::sort(result.symbols.begin(), result.symbols.end(),
+                      [](const SymbolInfo &a, const SymbolInfo &b) { return a.name < b.name; });
+            result.literals.reserve(littab.size());
+            for (size_t handle = 0; handle < littab.size(); ++handle) {
+                const Literal &lit = littab.at(static_cast<LiteralHandle>(handle));
+                result.literals.push_back(LiteralInfo{std::string(pool.name(lit.id)), std::string(lit.value),
+                                                      lit.address, lit.length, lit.assigned});
+            }
+        }
+    } catch (const std::exception &e) {
+        Console::err() << "Error: " << e.what() << std::endl;
+        result.ok = false;
+    }
+
+    collectDiagnostics(diagnostics.str(), result.diagnostics);
+    return result;
+}
@@ -0,0 +1,190 @@
+#include "../include/assembler.h"
+#include <cerrno>
+#include <cstring>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+static const char REQUEST_MAGIC[4] = {'S', 'X', 'R', 'Q'};
+static const char RESPONSE_MAGIC[4] = {'S', 'X', 'R', 'S'};
+
+const char *const AssemblerProtocol::DEFAULT_SOCKET = "/tmp/sicxe-assembler.sock";
+
+static void putU32(std::string &out, uint32_t value) {
+    out.append(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+static void putString(std::string &out, std::string_view text) {
+    putU32(out, static_cast<uint32_t>(text.size()));
+    out.append(text.data(), text.size());
+}
+
+// 메시지 본문을 앞에서부터 읽는다 (범위를 넘으면 ok가 false)
+struct MessageReader {
+    std::string_view rest;
+    bool ok;
+
+    explicit MessageReader(std::string_view bytes) : rest(bytes), ok(true) {}
+
+    uint32_t u32() {
+        uint32_t value = 0;
+        if (!ok || rest.size() < sizeof(value)) {
+            ok = false;
+            return 0;
+        }
+        std::memcpy(&value, rest.data(), sizeof(value));
+        rest.remove_prefix(sizeof(value));
+        return value;
+    }
+
+    std::string string() {
+        uint32_t n = u32();
+        if (!ok || rest.size() < n) {
+            ok = false;
+            return std::string();
+        }
+        std::string text(rest.substr(0, n));
+        rest.remove_prefix(n);
+        return text;
+    }
+
+    bool magic(const char (&expected)[4]) {
+        if (!ok || rest.size() < 4 || std::memcmp(rest.data(), expected, 4) != 0) {
+            ok = false;
+            return false;
+        }
+        rest.remove_prefix(4);
+        return u32() == AssemblerProtocol::VERSION && ok;
+    }
+};
+
+std::string AssemblerProtocol::encode(const AssembleRequest &request) {
+    std::string out;
+    out.append(REQUEST_MAGIC, sizeof(REQUEST_MAGIC));
+    putU32(out, VERSION);
+    putU32(out, request.command);
+    putU32(out, request.flags);
+    putU32(out, request.artifacts);
+    putString(out, request.source);
+    return out;
+}
+
+std::string AssemblerProtocol::encode(const AssembleResponse &response) {
+    size_t capacity = 64 + response.console.size() + response.diagnostics.size();
+    for (const auto &artifact : response.artifacts) {
+        capacity += 8 + artifact.first.size() + artifact.second.size();
+    }
+    std::string out;
+    out.reserve(capacity);
+    out.append(RESPONSE_MAGIC, sizeof(RESPONSE_MAGIC));
+    putU32(out, VERSION);
+    putU32(out, response.ok ? 1 : 0);
+    putString(out, response.console);
+    putString(out, response.diagnostics);
+    putU32(out, static_cast<uint32_t>(response.artifacts.size()));
+    for (const auto &artifact : response.artifacts) {
+        putString(out, artifact.first);
+        putString(out, artifact.second);
+    }
+    return out;
+}
+
+bool AssemblerProtocol::decode(std::string_view message, AssembleRequest &request) {
+    MessageReader in(message);
+    if (!in.magic(REQUEST_MAGIC)) {
+        return false;
+    }
+    request.command = static_cast<AssembleRequest::Command>(in.u32());
+    request.flags = in.u32();
+    request.artifacts = in.u32();
+    request.source = in.string();
+    return in.ok;
+}
+
+bool AssemblerProtocol::decode(std::string_view message, AssembleResponse &response) {
+    MessageReader in(message);
+    if (!in.magic(RESPONSE_MAGIC)) {
+        return false;
+    }
+    response.ok = in.u32() != 0;
+    response.console = in.string();
+    response.diagnostics = in.string();
+    uint32_t count = in.u32();
+    response.artifacts.clear();
+    for (uint32_t i = 0; i < count && in.ok; ++i) {
+        std::string name = in.string();
+        std::string contents = in.string();
+        response.artifacts.emplace_back(std::move(name), std::move(contents));
+    }
+    return in.ok;
+}
+
+bool AssemblerProtocol::send(int fd, const std::string &message) {
+    std::string framed;
+    framed.reserve(sizeof(uint32_t) + message.size());
+    putU32(framed, static_cast<uint32_t>(message.size()));
+    framed.append(message);
+
+    // 상대가 먼저 끊어도 SIGPIPE로 프로세스가 죽지 않도록
+#ifdef MSG_NOSIGNAL
+    const int flags = MSG_NOSIGNAL;
+#else
+    const int flags = 0;
+#endif
+    size_t sent = 0;
+    while (sent < framed.size()) {
+        ssize_t n = ::send(fd, framed.data() + sent, framed.size() - sent, flags);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        sent += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+// 정확히 size 바이트를 읽는다
+static bool readFully(int fd, char *data, size_t size) {
+    size_t got = 0;
+    while (got < size) {
+        ssize_t n = ::read(fd, data + got, size - got);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        got += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+bool AssemblerProtocol::receive(int fd, std::string &message) {
+    uint32_t length = 0;
+    if (!readFully(fd, reinterpret_cast<char *>(&length), sizeof(length)) || length > MAX_MESSAGE_SIZE) {
+        return false;
+    }
+    message.resize(length);
+    return readFully(fd, &message[0], length);
+}
+
+int AssemblerProtocol::connectTo(const std::string &socketPath) {
+    sockaddr_un address{};
+    if (socketPath.size() >= sizeof(address.sun_path)) {
+        return -1;
+    }
+    address.sun_family = AF_UNIX;
+    std::memcpy(address.sun_path, socketPath.c_str(), socketPath.size() + 1);
+
+    int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        return -1;
+    }
+    if (::connect(fd, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) != 0) {
+        ::close(fd);
+        return -1;
+    }
+    return fd;
+}
@@ -0,0 +1,182 @@
+#include "../include/assembler.h"
+#include <cerrno>
+#include <cstring>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// 요청마다 쓰는 아레나 첫 블록 크기 (작은 모듈이 대부분이므로 main보다 작게)
+static const size_t ARENA_INITIAL_SIZE = 64 << 10;
+// 요청을 보내다 멈춘 클라이언트가 작업 스레드를 붙잡지 않도록
+static const int CLIENT_TIMEOUT_SECONDS = 30;
+static const int LISTEN_BACKLOG = 64;
+
+AssemblerServer::AssemblerServer(const OPTAB *opt, const std::string &path, size_t count)
+    : optab(opt), socketPath(path), threads(count), listener(-1), stopping(false) {
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+}
+
+AssemblerServer::~AssemblerServer() {
+    if (listener >= 0) {
+        ::close(listener);
+        ::unlink(socketPath.c_str());
+    }
+}
+
+bool AssemblerServer::start() {
+    sockaddr_un address{};
+    if (socketPath.size() >= sizeof(address.sun_path)) {
+        Console::err() << "Error: Socket path too long: " << socketPath << std::endl;
+        return false;
+    }
+    // 연결되면 다른 서버가 쓰는 중, 아니면 이전 실행이 남긴 소켓 파일이므로 지운다
+    int existing = AssemblerProtocol::connectTo(socketPath);
+    if (existing >= 0) {
+        ::close(existing);
+        Console::err() << "Error: An assembler server is already listening on " << socketPath << std::endl;
+        return false;
+    }
+    ::unlink(socketPath.c_str());
+
+    address.sun_family = AF_UNIX;
+    std::memcpy(address.sun_path, socketPath.c_str(), socketPath.size() + 1);
+    listener = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listener < 0 || ::bind(listener, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) != 0 ||
+        ::listen(listener, LISTEN_BACKLOG) != 0) {
+        Console::err() << "Error: Cannot listen on " << socketPath << ": " << std::strerror(errno) << std::endl;
+        if (listener >= 0) {
+            ::close(listener);
+            listener = -1;
+        }
+        return false;
+    }
+    Console::out() << "Listening on " << socketPath << " (" << threads << " worker threads)" << std::endl;
+    return true;
+}
+
+void AssemblerServer::run() {
+    std::vector<std::thread> workers;
+    for (size_t i = 1; i < threads; ++i) {
+        workers.emplace_back(&AssemblerServer::serve, this);
+    }
+    serve();
+    for (std::thread &worker : workers) {
+        worker.join();
+    }
+}
+
+// 작업 스레드: 연결 하나에 요청 하나
+void AssemblerServer::serve() {
+    while (!stopping) {
+        int client = ::accept(listener, nullptr, nullptr);
+        if (client < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) {
+                continue;
+            }
+            // SHUTDOWN 요청이 listener를 shutdown하면 기다리던 accept()가 모두 실패하고 여기로 온다
+            return;
+        }
+        timeval timeout{CLIENT_TIMEOUT_SECONDS, 0};
+        ::setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        ::setsockopt(client, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+        handle(client);
+        ::close(client);
+    }
+}
+
+void AssemblerServer::handle(int client) {
+    std::string message;
+    AssembleRequest request;
+    if (!AssemblerProtocol::receive(client, message) || !AssemblerProtocol::decode(message, request)) {
+        AssembleResponse response{false, "", "Error: Malformed request\n", {}};
+        AssemblerProtocol::send(client, AssemblerProtocol::encode(response));
+        return;
+    }
+    if (request.command == AssembleRequest::SHUTDOWN) {
+        AssembleResponse response{true, "Assembler server stopping\n", "", {}};
+        AssemblerProtocol::send(client, AssemblerProtocol::encode(response));
+        stopping = true;
+        ::shutdown(listener, SHUT_RDWR);
+        return;
+    }
+    AssemblerProtocol::send(client, AssemblerProtocol::encode(assemble(request)));
+}
+
+// main의 2패스 흐름과 같지만 산출물은 파일 대신 응답에 담는다
+AssembleResponse AssemblerServer::assemble(const AssembleRequest &request) const {
+    AssembleResponse response{false, "", "", {}};
+    std::ostringstream console;
+    std::ostringstream diagnostics;
+    Console::redirect(&console, &diagnostics);
+
+    SourceFile file;
+    std::string_view text = request.source;
+    bool readable = true;
+    if ((request.flags & AssembleRequest::SOURCE_IS_PATH) != 0) {
+        readable = file.open(request.source);
+        if (readable) {
+            text = file.contents();
+        } else {
+            Console::err() << "Error: Cannot open source file: " << request.source << std::endl;
+        }
+    }
+
+    try {
+        // 요청 사이에는 병렬이므로 요청 하나는 직렬로 처리
+        std::pmr::monotonic_buffer_resource arena(ARENA_INITIAL_SIZE);
+        SymbolPool pool(optab, &arena);
+        SYMTAB symtab(&pool, &arena);
+        LITTAB littab(&pool, &arena);
+        Pass1 pass1(optab, &symtab, &littab, &pool, &arena);
+        if (readable && pass1.executeSource(text)) {
+            symtab.setProgramBlocks(&pass1.getProgramBlocks());
+            if ((request.artifacts & AssemblerProtocol::ARTIFACT_INTFILE) != 0) {
+                OutputBuffer out;
+                IntermediateFile::formatText(out, pass1.getIntFile(), pass1.getProgramBlocks(), pool);
+                response.artifacts.emplace_back("INTFILE", std::string(out.view()));
+                std::string binary;
+                IntermediateFile::encode(binary, pass1, symtab, littab, pool);
+                response.artifacts.emplace_back("INTFILE.bin", std::move(binary));
+            }
+            if ((request.artifacts & AssemblerProtocol::ARTIFACT_TABLES) != 0) {
+                OutputBuffer symbols;
+                symtab.format(symbols);
+                response.artifacts.emplace_back("SYMTAB.txt", std::string(symbols.view()));
+                OutputBuffer literals;
+                littab.format(literals);
+                response.artifacts.emplace_back("LITTAB.txt", std::string(literals.view()));
+            }
+
+            Pass2 pass2(optab, &symtab, &littab, &pool, pass1.getIntFile(), pass1.getStartAddress(),
+                        pass1.getProgramLength(), pass1.getProgramName(), pass1.getProgramBlocks(), &arena);
+            if (pass2.execute()) {
+                if ((request.artifacts & AssemblerProtocol::ARTIFACT_OBJFILE) != 0) {
+                    OutputBuffer out;
+                    pass2.formatObjectProgram(out);
+                    response.artifacts.emplace_back("OBJFILE", std::string(out.view()));
+                }
+                if ((request.artifacts & AssemblerProtocol::ARTIFACT_LISTING) != 0) {
+                    std::ostringstream listing;
+                    Console::redirect(&listing, &diagnostics);
+                    pass2.printListingFile();
+                    pass2.printObjFile();
+                    Console::redirect(&console, &diagnostics);
+                    response.artifacts.emplace_back("LISTING", listing.str());
+                }
+                response.ok = true;
+            }
+        }
+    } catch (const std::exception &e) {
+        // 요청 하나의 예외가 서버를 멈추지 않도록
+        Console::err() << "Error: " << e.what() << std::endl;
+        response.ok = false;
+    }
+
+    Console::redirect(nullptr, nullptr);
+    response.console = console.str();
+    response.diagnostics = diagnostics.str();
+    return response;
+}
@@ -0,0 +1,183 @@
+#include "../include/assembler.h"
+#include <cerrno>
+#include <chrono>
+#include <sys/stat.h>
+
+// 작업별 아레나 첫 블록 크기 (main과 같은 값)
+static const size_t ARENA_INITIAL_SIZE = 1 << 20;
+
+// 경로의 디렉터리를 앞에서부터 차례로 만든다 (이미 있으면 그대로)
+static bool makeDirectories(const std::string &path) {
+    for (size_t pos = path.find('/', 1); ; pos = path.find('/', pos + 1)) {
+        std::string prefix = path.substr(0, pos);
+        if (!prefix.empty() && mkdir(prefix.c_str(), 0755) != 0 && errno != EEXIST) {
+            return false;
+        }
+        if (pos == std::string::npos) {
+            return true;
+        }
+    }
+}
+
+static size_t fileSize(const std::string &filename) {
+    struct stat st {};
+    return stat(filename.c_str(), &st) == 0 ? static_cast<size_t>(st.st_size) : 0;
+}
+
+BatchAssembler::BatchAssembler(const OPTAB *opt, uint32_t emit) : optab(opt), artifacts(emit) {}
+
+void BatchAssembler::add(const std::string &source, const std::string &outputDir) {
+    std::string dir = outputDir;
+    if (dir.empty()) {
+        size_t slash = source.find_last_of('/');
+        std::string name = slash == std::string::npos ? source : source.substr(slash + 1);
+        size_t dot = name.find_last_of('.');
+        if (dot != std::string::npos && dot > 0) {
+            name.resize(dot);
+        }
+        // 이름이 같은 소스가 여러 개면 뒤에 번호를 붙인다
+        dir = "output/" + name;
+        for (int suffix = 2;; ++suffix) {
+            bool taken = std::any_of(jobs.begin(), jobs.end(),
+                                     [&](const BatchJob &job) { return job.outputDir == dir; });
+            if (!taken) {
+                break;
+            }
+            dir = "output/" + name + "_" + std::to_string(suffix);
+        }
+    }
+    jobs.push_back(BatchJob{source, dir, false, 0, 0, 0.0});
+}
+
+bool BatchAssembler::addManifest(const std::string &filename) {
+    std::ifstream manifest(filename);
+    if (!manifest) {
+        Console::err() << "Error: Cannot open manifest: " << filename << std::endl;
+        return false;
+    }
+    std::string line;
+    while (std::getline(manifest, line)) {
+        std::istringstream fields(line);
+        std::string source, outputDir;
+        if (!(fields >> source) || source[0] == '#') {
+            continue;
+        }
+        fields >> outputDir;
+        add(source, outputDir);
+    }
+    return true;
+}
+
+size_t BatchAssembler::size() const {
+    return jobs.size();
+}
+
+// 파일 하나를 main의 2패스 흐름 그대로 어셈블 (메시지는 작업 디렉터리의 LOG.txt로)
+void BatchAssembler::assembleJob(BatchJob &job) const {
+    std::ostringstream log;
+    Console::redirect(&log, &log);
+    auto t0 = std::chrono::steady_clock::now();
+
+    std::string dir = job.outputDir + "/";
+    SourceFile file;
+    if (!makeDirectories(job.outputDir)) {
+        Console::err() << "Error: Cannot create output directory: " << job.outputDir << std::endl;
+    } else if (!file.open(job.source)) {
+        Console::err() << "Error: Cannot open source file: " << job.source << std::endl;
+    } else {
+        std::string_view text = file.contents();
+        job.lines = static_cast<size_t>(std::count(text.begin(), text.end(), '\n'));
+        if (!text.empty() && text.back() != '\n') {
+            job.lines++;
+        }
+        try {
+            // 병렬성은 파일 단위로 얻으므로 작업 안에서는 직렬로 처리
+            std::pmr::monotonic_buffer_resource arena(ARENA_INITIAL_SIZE);
+            SymbolPool pool(optab, &arena);
+            SYMTAB symtab(&pool, &arena);
+            LITTAB littab(&pool, &arena);
+            Pass1 pass1(optab, &symtab, &littab, &pool, &arena);
+            if (pass1.executeSource(text)) {
+                symtab.setProgramBlocks(&pass1.getProgramBlocks());
+                if ((artifacts & Emit::INTFILE) != 0) {
+                    pass1.writeIntFile(dir + "INTFILE");
+                }
+                if ((artifacts & Emit::SYMTAB) != 0) {
+                    symtab.writeToFile(dir + "SYMTAB.txt");
+                }
+                if ((artifacts & Emit::INTFILE_BIN) != 0) {
+                    IntermediateFile::write(dir + "INTFILE.bin", pass1, symtab, littab, pool);
+                }
+                if ((artifacts & Emit::LITTAB) != 0) {
+                    littab.writeToFile(dir + "LITTAB.txt");
+                }
+
+                Pass2 pass2(optab, &symtab, &littab, &pool, pass1.getIntFile(), pass1.getStartAddress(),
+                            pass1.getProgramLength(), pass1.getProgramName(), pass1.getProgramBlocks(), &arena);
+                // 배치 작업은 리스팅을 만들지 않으므로 OBJFILE은 레코드 단위로 바로 쓴다
+                bool emitObject = (artifacts & Emit::OBJFILE) != 0;
+                if ((!emitObject || pass2.streamTo(dir + "OBJFILE")) && pass2.execute()) {
+                    job.ok = true;
+                }
+            }
+        } catch (const std::exception &e) {
+            // 한 파일의 예외가 배치 전체를 멈추지 않도록
+            Console::err() << "Error: " << e.what() << std::endl;
+            job.ok = false;
+        }
+    }
+
+    job.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    Console::redirect(nullptr, nullptr);
+
+    std::string messages = log.str();
+    std::istringstream lines(messages);
+    std::string line;
+    while (std::getline(lines, line)) {
+        if (line.compare(0, 5, "Error") == 0) {
+            job.errors++;
+        }
+    }
+    OutputBuffer out(messages.size());
+    out.append(messages);
+    out.writeTo(dir + "LOG.txt");
+}
+
+size_t BatchAssembler::run(size_t threads) {
+    WorkStealingPool workers(threads);
+    // 큰 파일부터 시작해야 마지막에 큰 파일 하나만 남아 다른 스레드가 노는 시간이 줄어든다
+    std::vector<size_t> order(jobs.size());
+    std::vector<size_t> sizes(jobs.size());
+    for (size_t i = 0; i < jobs.size(); ++i) {
+        order[i] = i;
+        sizes[i] = fileSize(jobs[i].source);
+    }
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return sizes[a] > sizes[b]; });
+
+    auto t0 = std::chrono::steady_clock::now();
+    workers.run(order.size(), [&](size_t k) { assembleJob(jobs[order[k]]); });
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    size_t failed = 0;
+    size_t totalLines = 0;
+    for (const BatchJob &job : jobs) {
+        failed += job.ok ? 0 : 1;
+        totalLines += job.lines;
+        Console::out() << (job.ok ? "  OK     " : "  FAILED ") << job.source << " -> " << job.outputDir << " ("
+                       << job.lines << " lines, " << std::fixed << std::setprecision(2) << job.seconds * 1000
+                       << " ms";
+        if (job.errors > 0) {
+            Console::out() << ", " << job.errors << " error(s), see " << job.outputDir << "/LOG.txt";
+        }
+        Console::out() << ")" << std::defaultfloat << std::endl;
+        // 요약을 끈 수준에서도 실패한 작업은 알린다
+        if (!job.ok && !Console::enabled(LogLevel::SUMMARY)) {
+            Console::err() << "Error: " << job.source << " failed, see " << job.outputDir << "/LOG.txt" << std::endl;
+        }
+    }
+    Console::out() << "Batch completed: " << jobs.size() - failed << "/" << jobs.size() << " files, "
+                   << totalLines << " lines in " << std::fixed << std::setprecision(3) << elapsed << " s ("
+                   << std::setprecision(0) << (elapsed > 0 ? totalLines / elapsed : 0.0) << " lines/s, "
+                   << workers.size() << " threads)" << std::defaultfloat << std::setprecision(6) << std::endl;
+    return failed;
+}
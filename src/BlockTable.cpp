@@ -0,0 +1,51 @@
+#include "../include/assembler.h"
+
+BlockTable::BlockTable() {
+    use("DEFAULT");
+}
+
+int BlockTable::use(std::string_view name) {
+    std::string key(name);
+    auto it = numbers.find(key);
+    if (it != numbers.end()) {
+        return it->second;
+    }
+
+    ProgramBlock block;
+    block.name = key;
+    block.number = static_cast<int>(blocks.size());
+    block.startAddress = 0;
+    block.length = 0;
+    block.currentLocctr = 0;
+    blocks.push_back(block);
+    numbers.emplace(key, block.number);
+    return block.number;
+}
+
+ProgramBlock &BlockTable::operator[](int number) {
+    return blocks[number];
+}
+
+const ProgramBlock &BlockTable::operator[](int number) const {
+    return blocks[number];
+}
+
+size_t BlockTable::size() const {
+    return blocks.size();
+}
+
+// 블록 시작 주소 + 블록 내 상대 주소 (알 수 없는 블록이면 상대 주소 그대로)
+int BlockTable::absoluteAddress(int number, int offset) const {
+    if (number < 0 || static_cast<size_t>(number) >= blocks.size()) {
+        return offset;
+    }
+    return blocks[number].startAddress + offset;
+}
+
+int BlockTable::totalLength() const {
+    int total = 0;
+    for (const ProgramBlock &block : blocks) {
+        total += block.length;
+    }
+    return total;
+}
@@ -0,0 +1,51 @@
+#include "../include/assembler.h"
+#include <cstdio>
+
+const size_t BufferedFile::FLUSH_SIZE;
+
+BufferedFile::BufferedFile() : buffer(FLUSH_SIZE + 256), ok(false) {}
+
+BufferedFile::~BufferedFile() {
+    if (file.is_open()) {
+        file.close();
+        std::remove(temporary.c_str());
+    }
+}
+
+bool BufferedFile::open(const std::string &filename) {
+    target = filename;
+    temporary = filename + ".tmp";
+    file.open(temporary, std::ios::binary | std::ios::trunc);
+    ok = file.is_open();
+    return ok;
+}
+
+OutputBuffer &BufferedFile::out() {
+    return buffer;
+}
+
+void BufferedFile::flushIfFull() {
+    if (buffer.size() < FLUSH_SIZE) {
+        return;
+    }
+    std::string_view data = buffer.view();
+    file.write(data.data(), static_cast<std::streamsize>(data.size()));
+    ok = ok && static_cast<bool>(file);
+    buffer.clear();
+}
+
+bool BufferedFile::close() {
+    if (!file.is_open()) {
+        return false;
+    }
+    std::string_view data = buffer.view();
+    file.write(data.data(), static_cast<std::streamsize>(data.size()));
+    buffer.clear();
+    file.close();
+    // 닫으면서 실패한 쓰기도 실패로 본다
+    ok = ok && static_cast<bool>(file) && std::rename(temporary.c_str(), target.c_str()) == 0;
+    if (!ok) {
+        std::remove(temporary.c_str());
+    }
+    return ok;
+}
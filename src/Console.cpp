@@ -0,0 +1,174 @@
+#include "../include/assembler.h"
+#include <atomic>
+#include <mutex>
+
+// 기본 출력을 이만큼 모으면 내보낸다
+static const size_t SINK_FLUSH_SIZE = 64 << 10;
+
+// 스레드마다 따로 (배치 작업 스레드가 서로의 출력을 섞지 않도록)
+static thread_local std::ostream *outTarget = nullptr;
+static thread_local std::ostream *errTarget = nullptr;
+// 돌린 스트림에도 출력 수준을 적용할지 (ConsoleRedirect의 keepLevel)
+static thread_local bool targetsKeepLevel = false;
+
+static std::atomic<LogLevel> currentLevel{LogLevel::VERBOSE};
+
+// 기본 출력: stdout 쪽은 모아 두고, stderr 쪽은 모인 것을 먼저 내보낸 뒤 바로 쓴다
+// 버퍼를 두지 않은 streambuf이므로 출력 연산마다 xsputn/overflow가 불려 잠금 한 번으로 끝난다
+class ConsoleSink : public std::streambuf {
+    bool diagnostic;
+
+public:
+    explicit ConsoleSink(bool isDiagnostic) : diagnostic(isDiagnostic) {}
+
+    static std::mutex &lock() {
+        static std::mutex mutex;
+        return mutex;
+    }
+
+    static std::string &pending() {
+        static std::string text;
+        return text;
+    }
+
+    // 잠금을 잡은 채로 부른다. 쓰는 시점의 std::cout으로 내보낸다 (rdbuf를 바꾼 벤치마크도 그대로 동작)
+    static void drain() {
+        std::string &text = pending();
+        if (!text.empty()) {
+            std::cout.write(text.data(), static_cast<std::streamsize>(text.size()));
+            text.clear();
+        }
+        std::cout.flush();
+    }
+
+protected:
+    std::streamsize xsputn(const char *s, std::streamsize n) override {
+        std::lock_guard<std::mutex> guard(lock());
+        if (diagnostic) {
+            drain();
+            std::cerr.write(s, n);
+        } else {
+            pending().append(s, static_cast<size_t>(n));
+            if (pending().size() >= SINK_FLUSH_SIZE) {
+                drain();
+            }
+        }
+        return n;
+    }
+
+    int overflow(int c) override {
+        if (c != traits_type::eof()) {
+            char ch = traits_type::to_char_type(c);
+            xsputn(&ch, 1);
+        }
+        return traits_type::not_eof(c);
+    }
+
+    // std::endl의 flush는 무시한다 (진행 메시지를 줄마다 쓰지 않도록)
+    int sync() override {
+        return 0;
+    }
+};
+
+struct ConsoleStreams {
+    ConsoleSink outSink{false};
+    ConsoleSink errSink{true};
+    std::ostream out{&outSink};
+    std::ostream err{&errSink};
+
+    // 잠금과 버퍼를 먼저 만들어 두어 이 객체보다 늦게 파괴되게 한다
+    ConsoleStreams() {
+        ConsoleSink::lock();
+        ConsoleSink::pending();
+    }
+
+    // 프로세스가 끝날 때 남은 출력을 내보낸다
+    ~ConsoleStreams() {
+        Console::flush();
+    }
+};
+
+static ConsoleStreams &streams() {
+    static ConsoleStreams instance;
+    return instance;
+}
+
+// 꺼진 수준의 메시지를 받는 스트림 (버퍼가 없으므로 출력 연산이 포맷 전에 바로 실패한다)
+static std::ostream &discard() {
+    static thread_local std::ostream stream(nullptr);
+    return stream;
+}
+
+std::ostream &Console::out() {
+    if (outTarget && !targetsKeepLevel) {
+        return *outTarget;
+    }
+    if (!enabled(LogLevel::SUMMARY)) {
+        return discard();
+    }
+    return outTarget ? *outTarget : streams().out;
+}
+
+std::ostream &Console::verbose() {
+    if (outTarget && !targetsKeepLevel) {
+        return *outTarget;
+    }
+    if (!enabled(LogLevel::VERBOSE)) {
+        return discard();
+    }
+    return outTarget ? *outTarget : streams().out;
+}
+
+std::ostream &Console::err() {
+    if (errTarget && !targetsKeepLevel) {
+        return *errTarget;
+    }
+    if (!enabled(LogLevel::ERRORS)) {
+        return discard();
+    }
+    return errTarget ? *errTarget : streams().err;
+}
+
+void Console::setLevel(LogLevel level) {
+    currentLevel = level;
+}
+
+bool Console::enabled(LogLevel level) {
+    return currentLevel.load(std::memory_order_relaxed) >= level;
+}
+
+bool Console::parseLevel(std::string_view name, LogLevel &level) {
+    static const std::pair<const char *, LogLevel> NAMES[] = {{"silent", LogLevel::SILENT},
+                                                              {"errors", LogLevel::ERRORS},
+                                                              {"summary", LogLevel::SUMMARY},
+                                                              {"verbose", LogLevel::VERBOSE}};
+    for (const auto &entry : NAMES) {
+        if (name == entry.first) {
+            level = entry.second;
+            return true;
+        }
+    }
+    return false;
+}
+
+void Console::redirect(std::ostream *out, std::ostream *err) {
+    outTarget = out;
+    errTarget = err;
+    targetsKeepLevel = false;
+}
+
+ConsoleRedirect::ConsoleRedirect(std::ostream *out, std::ostream *err, bool keepLevel)
+    : previousOut(outTarget), previousErr(errTarget), previousKeepLevel(targetsKeepLevel) {
+    Console::redirect(out, err);
+    targetsKeepLevel = keepLevel;
+}
+
+ConsoleRedirect::~ConsoleRedirect() {
+    Console::redirect(previousOut, previousErr);
+    targetsKeepLevel = previousKeepLevel;
+}
+
+void Console::flush() {
+    std::lock_guard<std::mutex> guard(ConsoleSink::lock());
+    ConsoleSink::drain();
+}
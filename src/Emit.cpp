@@ -0,0 +1,24 @@
+#include "../include/assembler.h"
+
+bool Emit::parse(std::string_view list, uint32_t &mask) {
+    static const std::pair<const char *, uint32_t> NAMES[] = {
+        {"objfile", OBJFILE}, {"intfile", INTFILE}, {"intbin", INTFILE_BIN}, {"symtab", SYMTAB},
+        {"littab", LITTAB},   {"listing", LISTING}, {"all", ALL},            {"none", 0}};
+    mask = 0;
+    while (!list.empty()) {
+        size_t comma = list.find(',');
+        std::string_view name = list.substr(0, comma);
+        list = comma == std::string_view::npos ? std::string_view() : list.substr(comma + 1);
+        bool known = false;
+        for (const auto &entry : NAMES) {
+            if (name == entry.first) {
+                mask |= entry.second;
+                known = true;
+            }
+        }
+        if (!known) {
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,245 @@
+#include "../include/assembler.h"
+#include <charconv>
+
+// Pratt 방식 단일 패스 컴파일러: 중위 표현식 → 후위 바이트코드
+// 우선순위: 단항 +,-  >  *,/  >  이항 +,-  (모두 왼쪽 결합)
+class ExpressionCompiler {
+private:
+    static const int MAX_NESTING = 256;
+
+    std::string_view text;
+    size_t pos;
+    int nesting;
+    int depth;
+    CompiledExpression &out;
+    SymbolPool *pool;
+
+    void skipSpace() {
+        while (pos < text.size() && (text[pos] == ' ' || text[pos] == '\t'))
+            pos++;
+    }
+
+    void emit(ExprInstr::Op op, int value = 0) {
+        out.code.push_back(ExprInstr{op, value});
+        if (op == ExprInstr::CONST || op == ExprInstr::SYMBOL || op == ExprInstr::LOCATION) {
+            depth++;
+            out.maxDepth = std::max(out.maxDepth, depth);
+        } else if (op != ExprInstr::NEG) {
+            depth--;
+        }
+    }
+
+    static int precedence(char c) {
+        if (c == '+' || c == '-')
+            return 1;
+        if (c == '*' || c == '/')
+            return 2;
+        return 0;
+    }
+
+    static bool isSymbolChar(char c) {
+        return isalnum(static_cast<unsigned char>(c)) || c == '_' || c == '$';
+    }
+
+    bool parseNumber() {
+        int base = 10;
+        if (pos + 2 < text.size() && text[pos] == '0' && (text[pos + 1] == 'x' || text[pos + 1] == 'X') &&
+            isxdigit(static_cast<unsigned char>(text[pos + 2]))) {
+            base = 16;
+            pos += 2;
+        }
+        int value = 0;
+        auto res = std::from_chars(text.data() + pos, text.data() + text.size(), value, base);
+        if (res.ec != std::errc()) {
+            return false;
+        }
+        pos = res.ptr - text.data();
+        emit(ExprInstr::CONST, value);
+        return true;
+    }
+
+    bool parsePrefix() {
+        skipSpace();
+        if (pos >= text.size())
+            return false;
+        char c = text[pos];
+
+        if (c == '-' || c == '+') {
+            pos++;
+            if (!parseExpression(3))
+                return false;
+            if (c == '-')
+                emit(ExprInstr::NEG);
+            return true;
+        }
+        if (c == '(') {
+            pos++;
+            if (!parseExpression(1))
+                return false;
+            skipSpace();
+            if (pos >= text.size() || text[pos] != ')')
+                return false;
+            pos++;
+            return true;
+        }
+        if (c == '*') {
+            // 현재 위치 카운터
+            pos++;
+            emit(ExprInstr::LOCATION);
+            return true;
+        }
+        if (isdigit(static_cast<unsigned char>(c))) {
+            return parseNumber();
+        }
+        if (isSymbolChar(c)) {
+            size_t start = pos;
+            while (pos < text.size() && isSymbolChar(text[pos]))
+                pos++;
+            out.symbols.push_back(pool->intern(text.substr(start, pos - start)));
+            emit(ExprInstr::SYMBOL, static_cast<int>(out.symbols.size() - 1));
+            return true;
+        }
+        return false;
+    }
+
+    bool parseExpression(int minPrecedence) {
+        if (++nesting > MAX_NESTING)
+            return false;
+        if (!parsePrefix())
+            return false;
+        for (;;) {
+            skipSpace();
+            if (pos >= text.size())
+                break;
+            char c = text[pos];
+            int prec = precedence(c);
+            if (prec == 0 || prec < minPrecedence)
+                break;
+            pos++;
+            if (!parseExpression(prec + 1))
+                return false;
+            switch (c) {
+            case '+':
+                emit(ExprInstr::ADD);
+                break;
+            case '-':
+                emit(ExprInstr::SUB);
+                break;
+            case '*':
+                emit(ExprInstr::MUL);
+                break;
+            default:
+                emit(ExprInstr::DIV);
+                break;
+            }
+        }
+        nesting--;
+        return true;
+    }
+
+public:
+    ExpressionCompiler(std::string_view src, CompiledExpression &target, SymbolPool *symbols)
+        : text(src), pos(0), nesting(0), depth(0), out(target), pool(symbols) {}
+
+    bool run() {
+        out.code.clear();
+        out.symbols.clear();
+        out.maxDepth = 0;
+        out.valid = parseExpression(1);
+        skipSpace();
+        if (pos != text.size())
+            out.valid = false;
+        return out.valid;
+    }
+};
+
+CompiledExpression::CompiledExpression(const allocator_type &alloc)
+    : code(alloc), symbols(alloc), maxDepth(0), valid(false) {}
+
+bool CompiledExpression::compile(std::string_view text, SymbolPool *pool) {
+    ExpressionCompiler compiler(Parser::trim(text), *this, pool);
+    return compiler.run();
+}
+
+bool CompiledExpression::isValid() const {
+    return valid;
+}
+
+int CompiledExpression::evaluate(const SYMTAB *symtab, int location) const {
+    // 대부분의 표현식은 고정 스택으로 충분 (깊은 경우만 힙 사용)
+    int fixedStack[32];
+    std::vector<int> bigStack;
+    int *stack = fixedStack;
+    if (maxDepth > 32) {
+        bigStack.resize(maxDepth);
+        stack = bigStack.data();
+    }
+    int top = 0;
+
+    for (const ExprInstr &instr : code) {
+        switch (instr.op) {
+        case ExprInstr::CONST:
+            stack[top++] = instr.value;
+            break;
+        case ExprInstr::LOCATION:
+            stack[top++] = location;
+            break;
+        case ExprInstr::SYMBOL: {
+            SymbolId symbol = symbols[instr.value];
+            SymbolHandle handle = symtab->find(symbol);
+            if (handle != NO_HANDLE) {
+                stack[top++] = symtab->at(handle).address;
+            } else {
+                Console::err() << "Error: Undefined symbol or invalid operand: "
+                               << symtab->getPool()->name(symbol) << std::endl;
+                stack[top++] = 0;
+            }
+            break;
+        }
+        case ExprInstr::NEG:
+            stack[top - 1] = -stack[top - 1];
+            break;
+        default: {
+            int right = stack[--top];
+            int &left = stack[top - 1];
+            if (instr.op == ExprInstr::ADD) {
+                left += right;
+            } else if (instr.op == ExprInstr::SUB) {
+                left -= right;
+            } else if (instr.op == ExprInstr::MUL) {
+                left *= right;
+            } else if (right == 0) {
+                Console::err() << "Error: Division by zero" << std::endl;
+                left = 0;
+            } else {
+                left /= right;
+            }
+            break;
+        }
+        }
+    }
+    return top > 0 ? stack[0] : 0;
+}
+
+ExpressionCache::ExpressionCache(std::pmr::memory_resource *memory) : texts(memory), compiled(memory) {}
+
+const CompiledExpression &ExpressionCache::get(std::string_view text, SymbolPool *pool) {
+    auto it = compiled.find(text);
+    if (it != compiled.end()) {
+        return it->second;
+    }
+    // 키는 캐시가 소유한 문자열을 가리키도록 복사해 둔다
+    texts.emplace_back(text);
+    CompiledExpression &expr = compiled[texts.back()];
+    expr.compile(texts.back(), pool);
+    return expr;
+}
+
+bool ExpressionCache::evaluate(std::string_view text, const SYMTAB *symtab, int location, int &value) {
+    const CompiledExpression &expr = get(text, symtab->getPool());
+    if (!expr.isValid()) {
+        return false;
+    }
+    value = expr.evaluate(symtab, location);
+    return true;
+}
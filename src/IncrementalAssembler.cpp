@@ -0,0 +1,148 @@
+#include "../include/assembler.h"
+#include <chrono>
+#include <cstring>
+
+IncrementalAssembler::Session::Session(const OPTAB *optab, ThreadPool *workers)
+    : pool(optab), symtab(&pool), littab(&pool),
+      pass1(optab, &symtab, &littab, &pool, std::pmr::get_default_resource(), workers) {
+    pass1.setIncremental(true);
+}
+
+IncrementalAssembler::IncrementalAssembler(const OPTAB *opt, ThreadPool *threads)
+    : optab(opt), workers(threads), dirty(0) {}
+
+// 공통 앞부분과 뒷부분을 줄 단위로 잘라 내고 가운데를 바뀐 범위로 본다 (같으면 false)
+bool IncrementalAssembler::diff(std::string_view before, std::string_view after, SourceEdit &edit) {
+    if (before == after) {
+        return false;
+    }
+    // 공통 부분은 블록 단위 memcmp로 건너뛰고 다른 블록 안에서만 바이트를 비교한다
+    const size_t BLOCK = 4096;
+    size_t limit = std::min(before.size(), after.size());
+    size_t prefix = 0;
+    while (prefix + BLOCK <= limit && std::memcmp(before.data() + prefix, after.data() + prefix, BLOCK) == 0) {
+        prefix += BLOCK;
+    }
+    prefix = std::mismatch(before.begin() + prefix, before.begin() + limit, after.begin() + prefix).first -
+             before.begin();
+    // 처음 다른 바이트가 있는 줄의 시작
+    size_t begin = prefix == 0 ? std::string_view::npos : before.rfind('\n', prefix - 1);
+    begin = begin == std::string_view::npos ? 0 : begin + 1;
+
+    size_t suffix = 0;
+    while (suffix + BLOCK <= limit - begin &&
+           std::memcmp(before.data() + before.size() - suffix - BLOCK, after.data() + after.size() - suffix - BLOCK,
+                       BLOCK) == 0) {
+        suffix += BLOCK;
+    }
+    while (suffix < limit - begin && before[before.size() - 1 - suffix] == after[after.size() - 1 - suffix]) {
+        suffix++;
+    }
+    // 뒷부분은 공통 부분 안의 개행 다음 줄부터
+    size_t end = before.find('\n', before.size() - suffix);
+    end = end == std::string_view::npos ? before.size() : end + 1;
+
+    edit.firstLine = static_cast<size_t>(std::count(before.begin(), before.begin() + begin, '\n'));
+    edit.beginByte = begin;
+    edit.oldBytes = end - begin;
+    edit.newBytes = after.size() - (before.size() - end) - begin;
+    std::string_view removed = before.substr(begin, edit.oldBytes);
+    edit.removedLines = static_cast<size_t>(std::count(removed.begin(), removed.end(), '\n'));
+    if (!removed.empty() && removed.back() != '\n') {
+        edit.removedLines++;
+    }
+    return true;
+}
+
+bool IncrementalAssembler::rebuild() {
+    session = std::make_unique<Session>(optab, workers);
+    Session &s = *session;
+    dirty = Emit::ALL;
+    if (!s.pass1.executeSource(base)) {
+        session.reset();
+        return false;
+    }
+    s.symtab.setProgramBlocks(&s.pass1.getProgramBlocks());
+    s.pass2 = std::make_unique<Pass2>(optab, &s.symtab, &s.littab, &s.pool, s.pass1.getIntFile(),
+                                      s.pass1.getStartAddress(), s.pass1.getProgramLength(),
+                                      s.pass1.getProgramName(), s.pass1.getProgramBlocks(),
+                                      std::pmr::get_default_resource(), workers);
+    if (!s.pass2->execute()) {
+        session.reset();
+        return false;
+    }
+    s.pass2->prepareUpdates();
+    return true;
+}
+
+bool IncrementalAssembler::assemble(const std::string &srcFilename) {
+    SourceFile file;
+    if (!file.open(srcFilename)) {
+        Console::err() << "Error: Cannot open source file: " << srcFilename << std::endl;
+        return false;
+    }
+    std::string_view text = file.contents();
+
+    auto t0 = std::chrono::steady_clock::now();
+    SourceEdit edit;
+    if (session && !diff(previous, text, edit)) {
+        Console::out() << "Source unchanged" << std::endl;
+        return true;
+    }
+    // 새 줄의 문자열은 중간 코드가 복사해 두므로 전체를 다시 할 때만 소스를 새로 잡는다
+    IntermediateEdit changes;
+    if (!session || !session->pass1.update(text, edit, changes)) {
+        if (session) {
+            Console::out() << "Edit changes the program layout, reassembling everything" << std::endl;
+        }
+        base.assign(text);
+        previous = base;
+        return rebuild();
+    }
+    previous.assign(text);
+    size_t reencoded = session->pass2->update(changes, session->pass1.getProgramLength());
+    auto t1 = std::chrono::steady_clock::now();
+    dirty |= Emit::OBJFILE | Emit::INTFILE | Emit::INTFILE_BIN | Emit::LISTING;
+    if (!changes.redefined.empty() || changes.shift != 0) {
+        dirty |= Emit::SYMTAB;
+    }
+    if (changes.shift != 0) {
+        dirty |= Emit::LITTAB;
+    }
+
+    Console::out() << "Incremental update: " << edit.removedLines << " line(s) replaced at line " << edit.firstLine + 1
+                   << ", " << reencoded << " line(s) encoded in "
+                   << std::chrono::duration<double, std::milli>(t1 - t0).count() << " ms" << std::endl;
+    return true;
+}
+
+void IncrementalAssembler::writeOutputs(uint32_t artifacts) {
+    if (!session) {
+        return;
+    }
+    session->pass1.settle();
+    session->pass2->settle();
+    artifacts &= dirty;
+    dirty &= ~artifacts;
+    if ((artifacts & Emit::INTFILE) != 0) {
+        session->pass1.writeIntFile("output/INTFILE");
+    }
+    if ((artifacts & Emit::INTFILE_BIN) != 0) {
+        IntermediateFile::write("output/INTFILE.bin", session->pass1, session->symtab, session->littab,
+                                session->pool);
+    }
+    if ((artifacts & Emit::SYMTAB) != 0) {
+        session->symtab.writeToFile("output/SYMTAB.txt");
+    }
+    if ((artifacts & Emit::LITTAB) != 0) {
+        session->littab.writeToFile("output/LITTAB.txt");
+    }
+    if ((artifacts & Emit::OBJFILE) != 0) {
+        session->pass2->writeObjFile("output/OBJFILE");
+    }
+    // 리스팅은 편집마다 다시 찍는다 (보이지 않으면 포맷 작업 자체를 건너뛴다)
+    if ((artifacts & Emit::LISTING) != 0 && Console::enabled(LogLevel::VERBOSE)) {
+        session->pass2->printListingFile();
+        session->pass2->printObjFile();
+    }
+}
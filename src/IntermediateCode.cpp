@@ -0,0 +1,269 @@
+#include "../include/assembler.h"
+
+const uint64_t IntermediateCode::TAG_SPACING;
+const uint64_t IntermediateCode::MAX_TAG_STEP;
+
+IntermediateCode::IntermediateCode(std::pmr::memory_resource *memory)
+    : extra(memory), kinds(memory), flags(memory), locations(memory), blockNumbers(memory), labels(memory),
+      opcodes(memory), operandRefs(memory), operands(memory), tagged(false), tags(memory), shifted(false),
+      definitions(memory) {}
+
+void IntermediateCode::setSource(std::string_view text) {
+    source = text;
+}
+
+// 소스 버퍼 안의 문자열은 위치만 기록하고, 밖의 문자열은 extra에 복사
+TextSpan IntermediateCode::spanOf(std::string_view text) {
+    TextSpan span;
+    span.length = static_cast<uint32_t>(text.size());
+    if (text.empty()) {
+        span.offset = 0;
+    } else if (text.data() >= source.data() && text.data() + text.size() <= source.data() + source.size()) {
+        span.offset = static_cast<uint32_t>(text.data() - source.data());
+    } else {
+        span.offset = static_cast<uint32_t>(extra.size()) | EXTRA_BIT;
+        extra.append(text);
+    }
+    return span;
+}
+
+std::string_view IntermediateCode::textOf(TextSpan span) const {
+    if (span.length == 0) {
+        return std::string_view();
+    }
+    if (span.offset & EXTRA_BIT) {
+        return std::string_view(extra).substr(span.offset & ~EXTRA_BIT, span.length);
+    }
+    return source.substr(span.offset, span.length);
+}
+
+// 위치는 지금 미뤄 둔 이동을 뺀 값으로 저장한다 (읽을 때 다시 더한다)
+void IntermediateCode::append(const IntermediateLine &line, uint64_t tag) {
+    kinds.push_back(line.kind);
+    flags.push_back((line.hasLocation ? HAS_LOCATION : 0) | (line.isFormat4 ? FORMAT4 : 0));
+    locations.push_back(line.location);
+    blockNumbers.push_back(line.blockNumber);
+    labels.push_back(line.labelId);
+    opcodes.push_back(line.opcodeId);
+    operandRefs.push_back(line.operandId);
+    operands.push_back(spanOf(line.operand));
+    if (tagged) {
+        tags.push_back(tag);
+        if (shifted && movesWithBlock(kinds.size() - 1)) {
+            locations.back() -= shiftAt(line.blockNumber, tag);
+        }
+    }
+}
+
+void IntermediateCode::push(const IntermediateLine &line) {
+    append(line, tagged ? nextTag() : 0);
+}
+
+// 새 줄의 태그는 지우는 줄의 태그를 앞에서부터 다시 쓰고, 모자라면 남은 간격을 나눠 붙인다
+void IntermediateCode::replace(size_t begin, size_t count, const std::vector<IntermediateLine> &lines) {
+    size_t tail = kinds.size();
+    size_t reused = std::min(count, lines.size());
+    uint64_t low = 0;
+    uint64_t step = 0;
+    if (tagged) {
+        low = reused > 0 ? tags[begin + reused - 1] : (begin > 0 ? tags[begin - 1] : 0);
+        uint64_t high = begin + count < tail ? tags[begin + count] : UINT64_MAX;
+        step = std::min((high - low) / (lines.size() - reused + 1), MAX_TAG_STEP);
+    }
+    for (size_t j = 0; j < lines.size(); ++j) {
+        append(lines[j], !tagged ? 0 : j < reused ? tags[begin + j] : low + step * (j - reused + 1));
+    }
+
+    // 뒤에 붙인 새 줄을 제자리로 옮긴다 (줄 수가 같으면 덮어쓰기만 한다)
+    auto move = [&](auto &column) {
+        std::vector<typename std::decay_t<decltype(column)>::value_type> added(column.begin() + tail, column.end());
+        column.resize(tail);
+        std::copy_n(added.begin(), reused, column.begin() + begin);
+        if (count > reused) {
+            column.erase(column.begin() + begin + reused, column.begin() + begin + count);
+        } else {
+            column.insert(column.begin() + begin + reused, added.begin() + reused, added.end());
+        }
+    };
+    move(kinds);
+    move(flags);
+    move(locations);
+    move(blockNumbers);
+    move(labels);
+    move(opcodes);
+    move(operandRefs);
+    move(operands);
+    if (tagged) {
+        move(tags);
+    }
+}
+
+IntermediateLine IntermediateCode::at(size_t index) const {
+    IntermediateLine line;
+    line.kind = kinds[index];
+    line.location = location(index);
+    line.labelId = labels[index];
+    line.opcodeId = opcodes[index];
+    line.operandId = operandRefs[index];
+    line.operand = textOf(operands[index]);
+    line.hasLocation = (flags[index] & HAS_LOCATION) != 0;
+    line.isFormat4 = (flags[index] & FORMAT4) != 0;
+    line.blockNumber = blockNumbers[index];
+    return line;
+}
+
+size_t IntermediateCode::size() const {
+    return kinds.size();
+}
+
+bool IntermediateCode::empty() const {
+    return kinds.empty();
+}
+
+LineKind IntermediateCode::kind(size_t index) const {
+    return kinds[index];
+}
+
+int IntermediateCode::location(size_t index) const {
+    if (shifted && movesWithBlock(index)) {
+        return locations[index] + shiftAt(blockNumbers[index], tags[index]);
+    }
+    return locations[index];
+}
+
+int IntermediateCode::blockNumber(size_t index) const {
+    return blockNumbers[index];
+}
+
+bool IntermediateCode::hasLocation(size_t index) const {
+    return (flags[index] & HAS_LOCATION) != 0;
+}
+
+// ==================== 태그 모드 ====================
+void IntermediateCode::setTagged(bool enabled) {
+    tagged = enabled;
+}
+
+// 위치 카운터를 따라 움직이는 줄 (USE 줄도 그 블록의 위치를 기록해 둔다)
+bool IntermediateCode::movesWithBlock(size_t index) const {
+    return (flags[index] & HAS_LOCATION) != 0 || kinds[index] == LineKind::USE;
+}
+
+uint64_t IntermediateCode::tag(size_t index) const {
+    return tags[index];
+}
+
+uint64_t IntermediateCode::nextTag() const {
+    return tags.empty() ? TAG_SPACING : tags.back() + TAG_SPACING;
+}
+
+size_t IntermediateCode::indexOf(uint64_t tag) const {
+    return static_cast<size_t>(std::lower_bound(tags.begin(), tags.end(), tag) - tags.begin());
+}
+
+bool IntermediateCode::canReplace(size_t begin, size_t count, size_t lines) const {
+    if (lines <= count) {
+        return true;
+    }
+    uint64_t low = count > 0 ? tags[begin + count - 1] : (begin > 0 ? tags[begin - 1] : 0);
+    uint64_t high = begin + count < tags.size() ? tags[begin + count] : UINT64_MAX;
+    return (high - low) / (lines - count + 1) > 0;
+}
+
+void IntermediateCode::shiftLocations(size_t from, int block, int shift, size_t blocks) {
+    if (shift == 0) {
+        return;
+    }
+    if (shifts.size() < blocks) {
+        shifts.resize(blocks);
+        startShifts.resize(blocks, 0);
+    }
+    // 같은 태그의 항목이 있으면 합치고, 뒤 항목의 누적 값에도 더한다
+    uint64_t tag = from < tags.size() ? tags[from] : UINT64_MAX;
+    std::vector<Shift> &list = shifts[block];
+    auto it = std::lower_bound(list.begin(), list.end(), tag,
+                               [](const Shift &entry, uint64_t value) { return entry.tag < value; });
+    if (it == list.end() || it->tag != tag) {
+        int32_t total = it == list.begin() ? 0 : std::prev(it)->total;
+        it = list.insert(it, Shift{tag, total});
+    }
+    for (; it != list.end(); ++it) {
+        it->total += shift;
+    }
+    for (size_t number = static_cast<size_t>(block) + 1; number < blocks; ++number) {
+        startShifts[number] += shift;
+    }
+    shifted = true;
+}
+
+int IntermediateCode::shiftAt(int block, uint64_t tag) const {
+    if (block < 0 || static_cast<size_t>(block) >= shifts.size()) {
+        return 0;
+    }
+    const std::vector<Shift> &list = shifts[block];
+    auto it = std::upper_bound(list.begin(), list.end(), tag,
+                               [](uint64_t value, const Shift &entry) { return value < entry.tag; });
+    return it == list.begin() ? 0 : std::prev(it)->total;
+}
+
+int IntermediateCode::locationShift(int block, uint64_t tag) const {
+    return shifted ? shiftAt(block, tag) : 0;
+}
+
+// SYMTAB은 절대 주소라 블록 시작 주소의 이동도 더한다
+int IntermediateCode::symbolShift(SymbolId symbol, int block) const {
+    if (!shifted) {
+        return 0;
+    }
+    int shift = static_cast<size_t>(block) < startShifts.size() ? startShifts[block] : 0;
+    const Definition &place = definition(symbol);
+    return place.block < 0 ? shift : shift + shiftAt(place.block, place.tag);
+}
+
+int IntermediateCode::literalShift(SymbolId literal) const {
+    if (!shifted) {
+        return 0;
+    }
+    const Definition &place = definition(literal);
+    return place.block < 0 ? 0 : shiftAt(place.block, place.tag);
+}
+
+size_t IntermediateCode::pendingShifts() const {
+    size_t count = 0;
+    for (const std::vector<Shift> &list : shifts) {
+        count += list.size();
+    }
+    return count;
+}
+
+void IntermediateCode::settle() {
+    if (!shifted) {
+        return;
+    }
+    for (size_t i = 0; i < locations.size(); ++i) {
+        if (movesWithBlock(i)) {
+            locations[i] += shiftAt(blockNumbers[i], tags[i]);
+        }
+    }
+    shifts.clear();
+    startShifts.clear();
+    shifted = false;
+}
+
+void IntermediateCode::define(SymbolId symbol, uint64_t tag, int block, bool located) {
+    if (symbol >= definitions.size()) {
+        definitions.resize(static_cast<size_t>(symbol) + 1, Definition{0, -1, false});
+    }
+    definitions[symbol] = Definition{tag, block, located};
+}
+
+void IntermediateCode::undefine(SymbolId symbol) {
+    if (symbol < definitions.size()) {
+        definitions[symbol].block = -1;
+    }
+}
+
+const IntermediateCode::Definition &IntermediateCode::definition(SymbolId symbol) const {
+    static const Definition NONE{0, -1, false};
+    return symbol < definitions.size() ? definitions[symbol] : NONE;
+}
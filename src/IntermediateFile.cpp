@@ -0,0 +1,340 @@
+#include "../include/assembler.h"
+#include <cstring>
+
+// 파일 구성 (모든 정수는 기계 고유 바이트 순서)
+//   헤더    : "SXIF" | version | byteOrder(0x01020304)
+//   프로그램 : name | start | length
+//   식별자 풀: 개수 | 문자열...
+//   블록     : 개수 | (name, start, length)...
+//   SYMTAB   : 개수 | SymbolEntry...
+//   LITTAB   : 개수 | (id, address, assigned)...
+//   IR       : source | extra | 열 배열...
+// 문자열은 u32 길이 + 바이트, 배열은 u32 개수 + 원소 바이트
+
+static const char MAGIC[4] = {'S', 'X', 'I', 'F'};
+static const uint32_t ENDIAN_MARK = 0x01020304u;
+
+static void putU32(std::string &out, uint32_t value) {
+    out.append(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+static void putI32(std::string &out, int32_t value) {
+    out.append(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+static void putString(std::string &out, std::string_view text) {
+    putU32(out, static_cast<uint32_t>(text.size()));
+    out.append(text.data(), text.size());
+}
+
+template <typename T>
+static void putArray(std::string &out, const std::pmr::vector<T> &values) {
+    putU32(out, static_cast<uint32_t>(values.size()));
+    out.append(reinterpret_cast<const char *>(values.data()), values.size() * sizeof(T));
+}
+
+// 매핑된 파일을 앞에서부터 읽는다 (범위를 넘으면 ok가 false)
+struct BinaryReader {
+    std::string_view rest;
+    bool ok;
+
+    explicit BinaryReader(std::string_view bytes) : rest(bytes), ok(true) {}
+
+    bool take(void *dst, size_t n) {
+        if (!ok || rest.size() < n) {
+            ok = false;
+            return false;
+        }
+        std::memcpy(dst, rest.data(), n);
+        rest.remove_prefix(n);
+        return true;
+    }
+
+    uint32_t u32() {
+        uint32_t value = 0;
+        take(&value, sizeof(value));
+        return value;
+    }
+
+    int32_t i32() {
+        int32_t value = 0;
+        take(&value, sizeof(value));
+        return value;
+    }
+
+    // 복사하지 않고 매핑된 영역을 그대로 가리킨다
+    std::string_view string() {
+        uint32_t n = u32();
+        if (!ok || rest.size() < n) {
+            ok = false;
+            return std::string_view();
+        }
+        std::string_view text = rest.substr(0, n);
+        rest.remove_prefix(n);
+        return text;
+    }
+
+    template <typename T>
+    void array(std::pmr::vector<T> &values) {
+        uint32_t n = u32();
+        if (!ok || rest.size() / sizeof(T) < n) {
+            ok = false;
+            return;
+        }
+        values.resize(n);
+        take(values.data(), n * sizeof(T));
+    }
+};
+
+IntermediateFile::IntermediateFile(std::pmr::memory_resource *memory)
+    : code(memory), startAddr(0), programLength(0) {}
+
+void IntermediateFile::encode(std::string &out, const Pass1 &pass1, const SYMTAB &symtab, const LITTAB &littab,
+                              const SymbolPool &pool) {
+    out.append(MAGIC, sizeof(MAGIC));
+    putU32(out, VERSION);
+    putU32(out, ENDIAN_MARK);
+
+    putString(out, pass1.getProgramName());
+    putI32(out, pass1.getStartAddress());
+    putI32(out, pass1.getProgramLength());
+
+    // 식별자 풀 (ID가 곧 순서이므로 그대로 다시 인터닝하면 같은 ID가 된다)
+    putU32(out, static_cast<uint32_t>(pool.size()));
+    for (size_t id = 0; id < pool.size(); ++id) {
+        putString(out, pool.name(static_cast<SymbolId>(id)));
+    }
+
+    const BlockTable &blocks = pass1.getProgramBlocks();
+    putU32(out, static_cast<uint32_t>(blocks.size()));
+    for (size_t number = 0; number < blocks.size(); ++number) {
+        const ProgramBlock &block = blocks[static_cast<int>(number)];
+        putString(out, block.name);
+        putI32(out, block.startAddress);
+        putI32(out, block.length);
+    }
+
+    putU32(out, static_cast<uint32_t>(symtab.size()));
+    for (size_t handle = 0; handle < symtab.size(); ++handle) {
+        const SymbolEntry &entry = symtab.at(static_cast<SymbolHandle>(handle));
+        putU32(out, entry.id);
+        putI32(out, entry.address);
+        putI32(out, entry.blockNumber);
+    }
+
+    putU32(out, static_cast<uint32_t>(littab.size()));
+    for (size_t handle = 0; handle < littab.size(); ++handle) {
+        const Literal &lit = littab.at(static_cast<LiteralHandle>(handle));
+        putU32(out, lit.id);
+        putI32(out, lit.address);
+        putU32(out, lit.assigned ? 1 : 0);
+    }
+
+    const IntermediateCode &code = pass1.getIntFile();
+    putString(out, code.source);
+    putString(out, code.extra);
+    putArray(out, code.kinds);
+    putArray(out, code.flags);
+    putArray(out, code.locations);
+    putArray(out, code.blockNumbers);
+    putArray(out, code.labels);
+    putArray(out, code.opcodes);
+    putArray(out, code.operandRefs);
+    putArray(out, code.operands);
+}
+
+bool IntermediateFile::write(const std::string &filename, const Pass1 &pass1, const SYMTAB &symtab,
+                             const LITTAB &littab, const SymbolPool &pool) {
+    std::string out;
+    encode(out, pass1, symtab, littab, pool);
+    if (!OutputBuffer::writeFile(filename, out)) {
+        Console::err() << "Error: Cannot write binary intermediate file" << std::endl;
+        return false;
+    }
+    Console::out() << "Binary intermediate file written: " << filename << std::endl;
+    return true;
+}
+
+bool IntermediateFile::load(const std::string &filename, SYMTAB *symtab, LITTAB *littab, SymbolPool *pool) {
+    if (!image.open(filename)) {
+        Console::err() << "Error: Cannot open intermediate file: " << filename << std::endl;
+        return false;
+    }
+    BinaryReader in(image.contents());
+
+    char magic[4] = {0, 0, 0, 0};
+    in.take(magic, sizeof(magic));
+    if (!in.ok || std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0) {
+        Console::err() << "Error: Not a binary intermediate file: " << filename << std::endl;
+        return false;
+    }
+    uint32_t version = in.u32();
+    uint32_t byteOrder = in.u32();
+    if (version != VERSION || byteOrder != ENDIAN_MARK) {
+        Console::err() << "Error: Unsupported intermediate file version " << version
+                       << " (expected " << VERSION << ")" << std::endl;
+        return false;
+    }
+
+    programName = std::string(in.string());
+    startAddr = in.i32();
+    programLength = in.i32();
+
+    // 식별자 풀 복원: Pass 1과 같은 OPTAB이 아니면 ID가 어긋난다
+    uint32_t names = in.u32();
+    for (uint32_t id = 0; in.ok && id < names; ++id) {
+        std::string_view name = in.string();
+        if (in.ok && pool->intern(name) != id) {
+            Console::err() << "Error: Intermediate file was built with a different OPTAB" << std::endl;
+            return false;
+        }
+    }
+
+    uint32_t blockCount = in.u32();
+    for (uint32_t number = 0; in.ok && number < blockCount; ++number) {
+        int restored = blocks.use(in.string());
+        ProgramBlock &block = blocks[restored];
+        block.startAddress = in.i32();
+        block.length = in.i32();
+        block.currentLocctr = block.length;
+    }
+
+    uint32_t symbolCount = in.u32();
+    for (uint32_t i = 0; in.ok && i < symbolCount; ++i) {
+        SymbolId id = in.u32();
+        int address = in.i32();
+        int blockNumber = in.i32();
+        if (id >= pool->size() || blockNumber < 0 || static_cast<size_t>(blockNumber) >= blocks.size()) {
+            in.ok = false;
+            break;
+        }
+        symtab->insert(id, address, blockNumber);
+    }
+
+    // 리터럴은 이름에서 값과 길이를 다시 계산하고 주소만 복원
+    uint32_t literalCount = in.u32();
+    for (uint32_t i = 0; in.ok && i < literalCount; ++i) {
+        SymbolId id = in.u32();
+        int address = in.i32();
+        bool assigned = in.u32() != 0;
+        if (id >= pool->size() || pool->name(id).empty()) {
+            in.ok = false;
+            break;
+        }
+        LiteralHandle handle = littab->find(littab->insert(pool->name(id)));
+        if (assigned) {
+            littab->assignAddress(handle, address);
+        }
+    }
+    littab->takePendingPool();
+
+    code.setSource(in.string());
+    code.extra = std::string(in.string());
+    in.array(code.kinds);
+    in.array(code.flags);
+    in.array(code.locations);
+    in.array(code.blockNumbers);
+    in.array(code.labels);
+    in.array(code.opcodes);
+    in.array(code.operandRefs);
+    in.array(code.operands);
+
+    size_t lines = code.kinds.size();
+    if (!in.ok || code.flags.size() != lines || code.locations.size() != lines ||
+        code.blockNumbers.size() != lines || code.labels.size() != lines ||
+        code.opcodes.size() != lines || code.operandRefs.size() != lines || code.operands.size() != lines ||
+        !validCode(pool->size())) {
+        Console::err() << "Error: Corrupt intermediate file: " << filename << std::endl;
+        return false;
+    }
+    symtab->setProgramBlocks(&blocks);
+    Console::out() << "Intermediate file loaded: " << filename << " (" << lines << " lines)" << std::endl;
+    return true;
+}
+
+// 잘못된 값이 남아 있으면 Pass 2가 범위를 벗어나 읽으므로 줄마다 확인한다
+bool IntermediateFile::validCode(size_t names) const {
+    auto validId = [names](SymbolId id) { return id == NO_SYMBOL || id < names; };
+    for (size_t i = 0; i < code.kinds.size(); ++i) {
+        if (code.kinds[i] > LineKind::UNKNOWN || code.blockNumbers[i] < 0 ||
+            static_cast<size_t>(code.blockNumbers[i]) >= blocks.size() || !validId(code.labels[i]) ||
+            !validId(code.opcodes[i]) || !validId(code.operandRefs[i])) {
+            return false;
+        }
+        const TextSpan &span = code.operands[i];
+        if (span.length == 0) {
+            continue;
+        }
+        size_t offset = span.offset & ~IntermediateCode::EXTRA_BIT;
+        size_t limit = (span.offset & IntermediateCode::EXTRA_BIT) ? code.extra.size() : code.source.size();
+        if (offset > limit || span.length > limit - offset) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void IntermediateFile::formatText(OutputBuffer &out, const IntermediateCode &code, const BlockTable &blocks,
+                                  const SymbolPool &pool) {
+    out.reserve(out.size() + code.size() * 64);
+    // 기존 ofstream 출력과 같게: 첫 줄 이후에는 std::left가 남아 주소가 왼쪽 정렬('0' 채움)된다
+    bool leftAlign = false;
+
+    for (size_t i = 0; i < code.size(); ++i) {
+        IntermediateLine line = code.at(i);
+        // START는 절대 주소로 표시, 나머지는 절대 주소 계산하여 표시
+        if (line.hasLocation) {
+            int absAddr;
+            if (line.kind == LineKind::START) {
+                // START는 원래 저장된 주소 사용
+                absAddr = line.location;
+            } else {
+                // 절대 주소 = 블록 시작 주소 + 블록 내 상대 주소
+                absAddr = blocks.absoluteAddress(line.blockNumber, line.location);
+            }
+            out.append("0x");
+            out.appendHexField(absAddr, 4, leftAlign, '0');
+            out.append("  ");
+        } else {
+            out.append("          ");
+        }
+
+        out.appendPadded(pool.name(line.labelId), 10);
+        out.appendPadded(pool.name(line.opcodeId), 10);
+        out.appendPadded(line.operand, 20);
+        out.append('\n');
+        leftAlign = true;
+    }
+}
+
+bool IntermediateFile::writeText(const std::string &filename, const IntermediateCode &code,
+                                 const BlockTable &blocks, const SymbolPool &pool) {
+    OutputBuffer out;
+    formatText(out, code, blocks, pool);
+    if (!out.writeTo(filename)) {
+        Console::err() << "Error: Cannot write intermediate file" << std::endl;
+        return false;
+    }
+    Console::out() << "Intermediate file written: " << filename << std::endl;
+    return true;
+}
+
+const IntermediateCode &IntermediateFile::getIntFile() const {
+    return code;
+}
+
+const BlockTable &IntermediateFile::getProgramBlocks() const {
+    return blocks;
+}
+
+std::string IntermediateFile::getProgramName() const {
+    return programName;
+}
+
+int IntermediateFile::getStartAddress() const {
+    return startAddr;
+}
+
+int IntermediateFile::getProgramLength() const {
+    return programLength;
+}
@@ -1,19 +1,21 @@
 #include "../include/assembler.h"
 
-LITTAB::LITTAB() {}
+LITTAB::LITTAB(SymbolPool *symbolPool, std::pmr::memory_resource *memory)
+    : pool(symbolPool), table(memory), index(memory), pending(memory) {}
 
-void LITTAB::insert(const std::string &literal) {
-    if (exists(literal)) {
-        return;
+SymbolId LITTAB::insert(std::string_view literal) {
+    SymbolId id = pool->intern(literal);
+    if (index.count(id)) {
+        return id;
     }
 
     Literal lit;
-    lit.name = literal;
-    lit.value = literal.substr(1); // '=' 제거
+    lit.id = id;
+    lit.value = std::string_view(pool->name(id)).substr(1); // '=' 제거
     lit.address = -1;
     lit.assigned = false;
     // 길이 계산
-    std::string val = lit.value;
+    std::string_view val = lit.value;
     int actualLength = 0;
 
     if (val.size() >= 3 && val[0] == 'C' && val[1] == '\'') {
@@ -33,53 +35,61 @@ void LITTAB::insert(const std::string &literal) {
 
     // 3바이트 미만이면 WORD(3바이트)로 처리
     lit.length = (actualLength < 3) ? 3 : actualLength;
+    LiteralHandle handle = static_cast<LiteralHandle>(table.size());
     table.push_back(lit);
+    index.emplace(id, handle);
+    pending.push_back(handle);
+    return id;
 }
 
-bool LITTAB::exists(const std::string &literal) const {
-    for (const auto &lit : table) {
-        if (lit.name == literal) {
-            return true;
-        }
-    }
-    return false;
+LiteralHandle LITTAB::find(SymbolId literal) const {
+    auto it = index.find(literal);
+    return it != index.end() ? it->second : NO_LITERAL;
 }
 
-void LITTAB::assignAddress(const std::string &literal, int addr) {
-    for (auto &lit : table) {
-        if (lit.name == literal) {
-            lit.address = addr;
-            lit.assigned = true;
-            return;
-        }
-    }
+const Literal &LITTAB::at(LiteralHandle handle) const {
+    return table[handle];
 }
 
-int LITTAB::getAddress(const std::string &literal) const {
-    for (const auto &lit : table) {
-        if (lit.name == literal) {
-            return lit.address;
-        }
-    }
-    return -1;
+void LITTAB::assignAddress(LiteralHandle handle, int addr) {
+    table[handle].address = addr;
+    table[handle].assigned = true;
 }
 
-int LITTAB::getLength(const std::string &literal) const {
-    for (const auto &lit : table) {
-        if (lit.name == literal) {
-            return lit.length;
-        }
-    }
-    return 0;
+std::pmr::vector<LiteralHandle> LITTAB::takePendingPool() {
+    std::pmr::vector<LiteralHandle> pool(pending.get_allocator());
+    pool.swap(pending);
+    return pool;
 }
 
-std::string LITTAB::getValue(const std::string &literal) const {
-    for (const auto &lit : table) {
-        if (lit.name == literal) {
-            return lit.value;
-        }
+size_t LITTAB::size() const {
+    return table.size();
+}
+
+bool LITTAB::exists(SymbolId literal) const {
+    return find(literal) != NO_LITERAL;
+}
+
+void LITTAB::assignAddress(SymbolId literal, int addr) {
+    LiteralHandle handle = find(literal);
+    if (handle != NO_LITERAL) {
+        assignAddress(handle, addr);
     }
-    return "";
+}
+
+int LITTAB::getAddress(SymbolId literal) const {
+    LiteralHandle handle = find(literal);
+    return handle != NO_LITERAL ? table[handle].address : -1;
+}
+
+int LITTAB::getLength(SymbolId literal) const {
+    LiteralHandle handle = find(literal);
+    return handle != NO_LITERAL ? table[handle].length : 0;
+}
+
+std::string_view LITTAB::getValue(SymbolId literal) const {
+    LiteralHandle handle = find(literal);
+    return handle != NO_LITERAL ? table[handle].value : std::string_view();
 }
 
 std::vector<Literal> LITTAB::getUnassignedLiterals() const {
@@ -93,61 +103,70 @@ std::vector<Literal> LITTAB::getUnassignedLiterals() const {
 }
 
 void LITTAB::print() const {
-    std::cout << "\n"
-              << std::string(70, '=') << std::endl;
-    std::cout << "LITERAL TABLE (LITTAB)" << std::endl;
-    std::cout << std::string(70, '=') << std::endl;
-    std::cout << std::left
-              << std::setw(20) << "Literal"
-              << std::setw(20) << "Value"
-              << std::setw(15) << "Address (Hex)"
-              << std::setw(10) << "Length" << std::endl;
-    std::cout << std::string(70, '-') << std::endl;
+    Console::out() << "\n"
+                   << std::string(70, '=') << std::endl;
+    Console::out() << "LITERAL TABLE (LITTAB)" << std::endl;
+    Console::out() << std::string(70, '=') << std::endl;
+    Console::out() << std::left
+                   << std::setw(20) << "Literal"
+                   << std::setw(20) << "Value"
+                   << std::setw(15) << "Address (Hex)"
+                   << std::setw(10) << "Length" << std::endl;
+    Console::out() << std::string(70, '-') << std::endl;
 
     for (const auto &lit : table) {
-        std::cout << std::left << std::setw(20) << lit.name
-                  << std::setw(20) << lit.value;
+        Console::out() << std::left << std::setw(20) << pool->name(lit.id)
+                       << std::setw(20) << lit.value;
         if (lit.assigned) {
-            std::cout << "0x" << std::hex << std::uppercase
-                      << std::setw(13) << std::setfill('0') << std::setw(4) << lit.address;
+            Console::out() << "0x" << std::hex << std::uppercase
+                           << std::setw(13) << std::setfill('0') << std::setw(4) << lit.address;
         } else {
-            std::cout << std::setw(15) << "unassigned";
+            Console::out() << std::setw(15) << "unassigned";
         }
-        std::cout << std::dec << std::setw(10) << lit.length
-                  << std::setfill(' ') << std::endl;
+        Console::out() << std::dec << std::setw(10) << lit.length
+                       << std::setfill(' ') << std::endl;
     }
-    std::cout << std::string(70, '=') << std::endl;
+    Console::out() << std::string(70, '=') << std::endl;
 }
 
-void LITTAB::writeToFile(const std::string &filename) const {
-    std::ofstream file(filename);
-    if (!file.is_open()) {
-        std::cerr << "Error: Cannot write LITTAB file" << std::endl;
-        return;
-    }
-
-    file << std::string(70, '=') << std::endl;
-    file << "LITERAL TABLE (LITTAB)" << std::endl;
-    file << std::string(70, '=') << std::endl;
-    file << std::left
-         << std::setw(20) << "Literal"
-         << std::setw(20) << "Value"
-         << std::setw(15) << "Address (Hex)"
-         << std::setw(10) << "Length" << std::endl;
-    file << std::string(70, '-') << std::endl;
+void LITTAB::format(OutputBuffer &out) const {
+    out.reserve(out.size() + 512 + table.size() * 80);
+    out.appendRepeat('=', 70);
+    out.append("\nLITERAL TABLE (LITTAB)\n");
+    out.appendRepeat('=', 70);
+    out.append('\n');
+    out.appendPadded("Literal", 20);
+    out.appendPadded("Value", 20);
+    out.appendPadded("Address (Hex)", 15);
+    out.appendPadded("Length", 10);
+    out.append('\n');
+    out.appendRepeat('-', 70);
+    out.append('\n');
 
     for (const auto &lit : table) {
-        file << std::left << std::setw(20) << lit.name
-             << std::setw(20) << lit.value;
+        out.appendPadded(pool->name(lit.id), 20);
+        out.appendPadded(lit.value, 20);
+        // 기존 ofstream 출력과 같게: 배정된 리터럴은 주소와 길이 모두 '0'으로 왼쪽 정렬 채움
+        char fill = lit.assigned ? '0' : ' ';
         if (lit.assigned) {
-            file << "0x" << std::hex << std::uppercase
-                 << std::setw(13) << std::setfill('0') << std::setw(4) << lit.address;
+            out.append("0x");
+            out.appendHexField(lit.address, 4, true, '0');
         } else {
-            file << std::setw(15) << "unassigned";
+            out.appendPadded("unassigned", 15);
         }
-        file << std::dec << std::setw(10) << lit.length
-             << std::setfill(' ') << std::endl;
+        out.appendDecimalField(lit.length, 10, true, fill);
+        out.append('\n');
     }
-    file << std::string(70, '=') << std::endl;
-    file.close();
-}
\ No newline at end of file
+    out.appendRepeat('=', 70);
+    out.append('\n');
+}
+
+bool LITTAB::writeToFile(const std::string &filename) const {
+    OutputBuffer out;
+    format(out);
+    if (!out.writeTo(filename)) {
+        Console::err() << "Error: Cannot write LITTAB file" << std::endl;
+        return false;
+    }
+    return true;
+}
@@ -1,32 +1,117 @@
 #include "../include/assembler.h"
 
-OPTAB::OPTAB() {}
-
-int OPTAB::determineFormat(const std::string &mnemonic) {
-    // Format 2 명령어들 (레지스터 연산)
-    if (mnemonic == "ADDR" || mnemonic == "SUBR" || mnemonic == "MULR" ||
-        mnemonic == "DIVR" || mnemonic == "COMPR" || mnemonic == "CLEAR" ||
-        mnemonic == "RMO" || mnemonic == "SHIFTL" || mnemonic == "SHIFTR" ||
-        mnemonic == "SVC" || mnemonic == "TIXR") {
-        return 2;
+// ==================== 내장 SIC/XE 명령어 집합 ====================
+struct BuiltinInstruction {
+    std::string_view mnemonic;
+    uint8_t opcode;
+    uint8_t format;
+};
+
+static constexpr BuiltinInstruction BUILTIN_INSTRUCTIONS[] = {
+    {"ADD", 0x18, 3}, {"ADDF", 0x58, 3}, {"ADDR", 0x90, 2}, {"AND", 0x40, 3},
+    {"CLEAR", 0xB4, 2}, {"COMP", 0x28, 3}, {"COMPF", 0x88, 3}, {"COMPR", 0xA0, 2},
+    {"DIV", 0x24, 3}, {"DIVF", 0x64, 3}, {"DIVR", 0x9C, 2}, {"FIX", 0xC4, 1},
+    {"FLOAT", 0xC0, 1}, {"HIO", 0xF4, 1}, {"J", 0x3C, 3}, {"JEQ", 0x30, 3},
+    {"JGT", 0x34, 3}, {"JLT", 0x38, 3}, {"JSUB", 0x48, 3}, {"LDA", 0x00, 3},
+    {"LDB", 0x68, 3}, {"LDCH", 0x50, 3}, {"LDF", 0x70, 3}, {"LDL", 0x08, 3},
+    {"LDS", 0x6C, 3}, {"LDT", 0x74, 3}, {"LDX", 0x04, 3}, {"LPS", 0xD0, 3},
+    {"MUL", 0x20, 3}, {"MULF", 0x60, 3}, {"MULR", 0x98, 2}, {"NORM", 0xC8, 1},
+    {"OR", 0x44, 3}, {"RD", 0xD8, 3}, {"RMO", 0xAC, 2}, {"RSUB", 0x4C, 3},
+    {"SHIFTL", 0xA4, 2}, {"SHIFTR", 0xA8, 2}, {"SIO", 0xF0, 1}, {"SSK", 0xEC, 3},
+    {"STA", 0x0C, 3}, {"STB", 0x78, 3}, {"STCH", 0x54, 3}, {"STF", 0x80, 3},
+    {"STI", 0xD4, 3}, {"STL", 0x14, 3}, {"STS", 0x7C, 3}, {"STSW", 0xE8, 3},
+    {"STT", 0x84, 3}, {"STX", 0x10, 3}, {"SUB", 0x1C, 3}, {"SUBF", 0x5C, 3},
+    {"SUBR", 0x94, 2}, {"SVC", 0xB0, 2}, {"TD", 0xE0, 3}, {"TIO", 0xF8, 1},
+    {"TIX", 0x2C, 3}, {"TIXR", 0xB8, 2}, {"WD", 0xDC, 3},
+};
+
+static constexpr size_t BUILTIN_COUNT = sizeof(BUILTIN_INSTRUCTIONS) / sizeof(BUILTIN_INSTRUCTIONS[0]);
+
+// ==================== 컴파일 타임 완전 해시 ====================
+// 충돌이 없는 seed를 컴파일 시점에 찾아 슬롯 → 명령어 인덱스 표를 만든다
+static constexpr size_t PERFECT_HASH_SLOTS = 256;
+
+struct PerfectHashTable {
+    uint32_t seed;
+    uint8_t slots[PERFECT_HASH_SLOTS]; // 명령어 인덱스 + 1 (0은 빈 슬롯)
+};
+
+static constexpr uint32_t mnemonicHash(std::string_view name, uint32_t seed) {
+    uint32_t h = 2166136261u ^ (seed * 16777619u);
+    for (char c : name) {
+        h ^= static_cast<uint8_t>(c);
+        h *= 16777619u;
+    }
+    return (h ^ (h >> 15)) & (PERFECT_HASH_SLOTS - 1);
+}
+
+static constexpr PerfectHashTable buildPerfectHash() {
+    for (uint32_t seed = 1; seed < 100000; ++seed) {
+        PerfectHashTable table{};
+        table.seed = seed;
+        bool collision = false;
+        for (size_t i = 0; i < BUILTIN_COUNT && !collision; ++i) {
+            uint32_t slot = mnemonicHash(BUILTIN_INSTRUCTIONS[i].mnemonic, seed);
+            if (table.slots[slot] != 0) {
+                collision = true;
+            } else {
+                table.slots[slot] = static_cast<uint8_t>(i + 1);
+            }
+        }
+        if (!collision) {
+            return table;
+        }
     }
-    // Format 1 명령어들 (피연산자 없음)
-    if (mnemonic == "FIX" || mnemonic == "FLOAT" || mnemonic == "HIO" ||
-        mnemonic == "NORM" || mnemonic == "SIO" || mnemonic == "TIO") {
-        return 1;
+    return PerfectHashTable{};
+}
+
+static constexpr PerfectHashTable BUILTIN_HASH = buildPerfectHash();
+static_assert(BUILTIN_HASH.seed != 0, "no collision-free seed for the built-in OPTAB");
+static_assert(BUILTIN_COUNT < 255, "slot index must fit in uint8_t");
+
+// 내장 명령어 인덱스 (없으면 -1): 해시 한 번 + 문자열 비교 한 번
+static int findBuiltin(std::string_view mnemonic) {
+    uint8_t slot = BUILTIN_HASH.slots[mnemonicHash(mnemonic, BUILTIN_HASH.seed)];
+    if (slot != 0 && BUILTIN_INSTRUCTIONS[slot - 1].mnemonic == mnemonic) {
+        return slot - 1;
+    }
+    return -1;
+}
+
+OPTAB::OPTAB() {
+    mnemonics.reserve(BUILTIN_COUNT);
+    entries.reserve(BUILTIN_COUNT);
+    for (const BuiltinInstruction &builtin : BUILTIN_INSTRUCTIONS) {
+        mnemonics.push_back(builtin.mnemonic);
+        entries.push_back(InstructionInfo{builtin.opcode, builtin.format});
+    }
+}
+
+int OPTAB::determineFormat(std::string_view mnemonic) const {
+    // 내장 명령어면 그 형식을 따르고, 새 니모닉은 Format 3/4로 본다
+    int builtin = findBuiltin(mnemonic);
+    return builtin >= 0 ? BUILTIN_INSTRUCTIONS[builtin].format : 3;
+}
+
+int OPTAB::indexOf(std::string_view mnemonic) const {
+    int builtin = findBuiltin(mnemonic);
+    if (builtin >= 0 || extensions.empty()) {
+        return builtin;
     }
-    // 나머지는 Format 3/4 (기본 3, + 접두사면 4)
-    return 3;
+    auto it = extensions.find(mnemonic);
+    return it != extensions.end() ? static_cast<int>(it->second) : -1;
 }
 
+// 내장 표를 추가/재정의하는 파일: "MNEMONIC OPCODE [FORMAT]" (OPCODE는 16진수)
 bool OPTAB::load(const std::string &filename) {
     std::ifstream file(filename);
     if (!file.is_open()) {
-        std::cerr << "Error: Cannot open OPTAB file: " << filename << std::endl;
+        Console::err() << "Error: Cannot open OPTAB file: " << filename << std::endl;
         return false;
     }
     std::string line;
     int lineNum = 0;
+    int loaded = 0;
     while (std::getline(file, line)) {
         lineNum++;
 
@@ -36,53 +121,97 @@ bool OPTAB::load(const std::string &filename) {
 
         std::istringstream iss(line);
         std::string mnemonic, opcode;
+        int format = 0;
 
         if (iss >> mnemonic >> opcode) {
-            InstructionInfo info;
-            info.opcode = opcode;
-            info.format = determineFormat(mnemonic);
-            table[mnemonic] = info;
+            int opcodeValue = 0;
+            if (!Parser::parseNumber(opcode, 16, opcodeValue) || opcodeValue < 0 || opcodeValue > 0xFF) {
+                Console::err() << "Warning: Invalid opcode at OPTAB line " << lineNum << ": " << opcode << std::endl;
+                continue;
+            }
+            if (!(iss >> format) || format < 1 || format > 3) {
+                format = determineFormat(mnemonic);
+            }
+            InstructionInfo info{static_cast<uint8_t>(opcodeValue), static_cast<uint8_t>(format)};
+
+            int index = indexOf(mnemonic);
+            if (index >= 0) {
+                entries[index] = info;
+            } else {
+                extensionNames.push_back(mnemonic);
+                extensions[mnemonic] = mnemonics.size();
+                mnemonics.push_back(extensionNames.back());
+                entries.push_back(info);
+            }
+            loaded++;
         }
     }
     file.close();
-    std::cout << "OPTAB loaded: " << table.size() << " instructions" << std::endl;
+    if (loaded > 0) {
+        Console::out() << "OPTAB extended from " << filename << ": " << loaded << " entries" << std::endl;
+    }
     return true;
 }
 
-bool OPTAB::isInstruction(const std::string &mnemonic) const {
-    return table.find(mnemonic) != table.end();
+bool OPTAB::isInstruction(std::string_view mnemonic) const {
+    return indexOf(mnemonic) >= 0;
 }
 
-std::string OPTAB::getOpcode(const std::string &mnemonic) const {
-    auto it = table.find(mnemonic);
-    if (it != table.end()) {
-        return it->second.opcode;
-    }
-    return "";
+int OPTAB::getOpcode(std::string_view mnemonic) const {
+    int index = indexOf(mnemonic);
+    return index >= 0 ? entries[index].opcode : -1;
 }
 
-int OPTAB::getFormat(const std::string &mnemonic) const {
-    auto it = table.find(mnemonic);
-    if (it != table.end()) {
-        return it->second.format;
-    }
-    return 0;
+int OPTAB::getFormat(std::string_view mnemonic) const {
+    int index = indexOf(mnemonic);
+    return index >= 0 ? entries[index].format : 0;
+}
+
+bool OPTAB::isInstruction(SymbolId id) const {
+    return id < entries.size();
+}
+
+int OPTAB::getOpcode(SymbolId id) const {
+    return id < entries.size() ? entries[id].opcode : -1;
+}
+
+int OPTAB::getFormat(SymbolId id) const {
+    return id < entries.size() ? entries[id].format : 0;
+}
+
+size_t OPTAB::size() const {
+    return mnemonics.size();
+}
+
+std::string_view OPTAB::getMnemonic(size_t index) const {
+    return mnemonics[index];
 }
 
 void OPTAB::printTable() const {
-    std::cout << "\n"
-              << std::string(60, '=') << std::endl;
-    std::cout << "OPERATION CODE TABLE (OPTAB)" << std::endl;
-    std::cout << std::string(60, '=') << std::endl;
-    std::cout << std::left << std::setw(15) << "Mnemonic"
-              << std::setw(10) << "Opcode"
-              << std::setw(10) << "Format" << std::endl;
-    std::cout << std::string(60, '-') << std::endl;
-
-    for (const auto &entry : table) {
-        std::cout << std::left << std::setw(15) << entry.first
-                  << std::setw(10) << entry.second.opcode
-                  << "Format " << entry.second.format << std::endl;
+    Console::out() << "\n"
+                   << std::string(60, '=') << std::endl;
+    Console::out() << "OPERATION CODE TABLE (OPTAB)" << std::endl;
+    Console::out() << std::string(60, '=') << std::endl;
+    Console::out() << std::left << std::setw(15) << "Mnemonic"
+                   << std::setw(10) << "Opcode"
+                   << std::setw(10) << "Format" << std::endl;
+    Console::out() << std::string(60, '-') << std::endl;
+
+    std::vector<size_t> order(mnemonics.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+        order[i] = i;
+    }
+    std::sort(order.begin(), order.end(), [this](size_t a, size_t b) {
+        return mnemonics[a] < mnemonics[b];
+    });
+
+    for (size_t index : order) {
+        const InstructionInfo &info = entries[index];
+        Console::out() << std::left << std::setw(15) << mnemonics[index]
+                       << std::hex << std::uppercase << std::right << std::setfill('0') << std::setw(2)
+                       << static_cast<int>(info.opcode) << std::string(8, ' ')
+                       << std::dec << std::left << std::setfill(' ')
+                       << "Format " << static_cast<int>(info.format) << std::endl;
     }
-    std::cout << std::string(60, '=') << std::endl;
+    Console::out() << std::string(60, '=') << std::endl;
 }
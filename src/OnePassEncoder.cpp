@@ -0,0 +1,259 @@
+#include "../include/assembler.h"
+
+OnePassEncoder::OnePassEncoder(const OPTAB *opt, SYMTAB *sym, LITTAB *lit, SymbolPool *pool,
+                               std::pmr::memory_resource *memory)
+    : optab(opt), symbols(sym), littab(lit), resolved(pool, memory), none(memory),
+      encoder(opt, &resolved, lit, pool, none, 0, 0, "", blocks, memory),
+      emitted(memory), fixups(memory), chains(memory), pendingBases(memory), base{-1, -1},
+      lookahead(), hasLookahead(false), endLine(), started(false), restarted(false), ended(false),
+      layoutKnown(false), startAddr(0) {}
+
+// 지금 인코딩할 수 없으면 기다려야 할 ID (바로 할 수 있으면 NO_SYMBOL)
+SymbolId OnePassEncoder::blocker(const IntermediateLine &line, const BaseState &state) const {
+    // 주소에 따라 바이트가 달라지는 줄: 형식 3/4 (PC/BASE 상대, 수정 레코드)와 WORD
+    bool format3 = line.kind == LineKind::INSTRUCTION && !line.isFormat4 && optab->getFormat(line.opcodeId) == 3;
+    bool addressed = format3 || (line.kind == LineKind::INSTRUCTION && line.isFormat4) || line.kind == LineKind::WORD;
+    if (!addressed || layoutKnown) {
+        return NO_SYMBOL;
+    }
+    if (!started || line.blockNumber != 0) {
+        return WAIT_LAYOUT;
+    }
+    if (line.operandId != NO_SYMBOL) {
+        LiteralHandle literal = littab->find(line.operandId);
+        if (literal != NO_LITERAL) {
+            if (!littab->at(literal).assigned) {
+                return line.operandId;
+            }
+        } else if (resolved.find(line.operandId) == NO_HANDLE) {
+            return line.operandId;
+        }
+    }
+    if (format3 && state.pending >= 0) {
+        SymbolId baseSymbol = pendingBases[state.pending].line.operandId;
+        if (resolved.find(baseSymbol) == NO_HANDLE) {
+            return baseSymbol;
+        }
+    }
+    return NO_SYMBOL;
+}
+
+int OnePassEncoder::resolvePending(int32_t index) const {
+    const PendingBase &pending = pendingBases[index];
+    int value = pending.previous >= 0 ? resolvePending(pending.previous) : pending.previousValue;
+    encoder.resolveBase(pending.line, value);
+    return value;
+}
+
+int OnePassEncoder::baseValue(const BaseState &state) const {
+    return state.pending >= 0 ? resolvePending(state.pending) : state.value;
+}
+
+void OnePassEncoder::encode(const IntermediateLine &line, int nextLoc, const BaseState &state) {
+    scratch.bytes.clear();
+    scratch.modifications.clear();
+    scratch.baseRegister = baseValue(state);
+    encoder.generateObjectCode(line, nextLoc, scratch);
+    encoder.printMessages(scratch);
+}
+
+// 바로 인코딩하거나, 자리만 잡아 두고 fixup 체인에 건다
+void OnePassEncoder::place(const IntermediateLine &line, int nextLoc) {
+    EmittedLine out{line.blockNumber, line.location, static_cast<uint32_t>(encoder.objectBytes.size()), 0,
+                    ModificationRecord{0, 0}, false};
+    SymbolId waitFor = blocker(line, base);
+    if (waitFor == NO_SYMBOL) {
+        encode(line, nextLoc, base);
+        encoder.objectBytes.insert(encoder.objectBytes.end(), scratch.bytes.begin(), scratch.bytes.end());
+        out.length = static_cast<uint32_t>(scratch.bytes.size());
+        if (!scratch.modifications.empty()) {
+            out.modification = scratch.modifications.front();
+        }
+    } else {
+        out.length = line.isFormat4 ? 4 : 3;
+        encoder.objectBytes.resize(encoder.objectBytes.size() + out.length, 0);
+        fixups.push_back(Fixup{line, nextLoc, base, static_cast<uint32_t>(emitted.size()), -1, false});
+        link(static_cast<int32_t>(fixups.size() - 1), waitFor);
+    }
+    emitted.push_back(out);
+}
+
+void OnePassEncoder::link(int32_t fixup, SymbolId id) {
+    if (id == WAIT_LAYOUT) {
+        return;
+    }
+    auto it = chains.find(id);
+    fixups[fixup].next = it != chains.end() ? it->second : -1;
+    chains[id] = fixup;
+}
+
+void OnePassEncoder::resolveFixup(int32_t index) {
+    Fixup &fixup = fixups[index];
+    SymbolId waitFor = blocker(fixup.line, fixup.base);
+    if (waitFor != NO_SYMBOL) {
+        // BASE 심볼처럼 다른 ID를 더 기다려야 하면 그 체인으로 옮긴다
+        link(index, waitFor);
+        return;
+    }
+    encode(fixup.line, fixup.nextLoc, fixup.base);
+    EmittedLine &out = emitted[fixup.emitted];
+    size_t count = std::min<size_t>(out.length, scratch.bytes.size());
+    std::copy(scratch.bytes.begin(), scratch.bytes.begin() + count, encoder.objectBytes.begin() + out.offset);
+    if (!scratch.modifications.empty()) {
+        out.modification = scratch.modifications.front();
+    }
+    fixup.done = true;
+}
+
+void OnePassEncoder::wake(SymbolId id) {
+    auto it = chains.find(id);
+    if (it == chains.end()) {
+        return;
+    }
+    int32_t index = it->second;
+    chains.erase(it);
+    while (index >= 0) {
+        int32_t next = fixups[index].next;
+        resolveFixup(index);
+        index = next;
+    }
+}
+
+// 기본 블록 심볼은 START 주소 + 블록 내 주소로 바로 확정 (Pass1::finalizeBlocks와 같은 값)
+void OnePassEncoder::define(SymbolId id) {
+    if (!started || resolved.find(id) != NO_HANDLE) {
+        return;
+    }
+    SymbolHandle handle = symbols->find(id);
+    if (handle == NO_HANDLE || symbols->at(handle).blockNumber != 0) {
+        return;
+    }
+    resolved.insert(id, startAddr + symbols->at(handle).address, 0);
+    wake(id);
+}
+
+void OnePassEncoder::line(const IntermediateLine &line) {
+    // 붙잡아 둔 앞 줄의 nextLoc 확정 (Pass2::encodeChunk와 같은 규칙)
+    if (hasLookahead) {
+        int nextLoc = lookahead.location;
+        if (line.blockNumber == lookahead.blockNumber && line.hasLocation) {
+            nextLoc = line.location;
+        } else if (lookahead.kind == LineKind::INSTRUCTION) {
+            nextLoc = lookahead.location + (lookahead.isFormat4 ? 4 : optab->getFormat(lookahead.opcodeId));
+        }
+        hasLookahead = false;
+        place(lookahead, nextLoc);
+    }
+
+    switch (line.kind) {
+    case LineKind::START:
+        restarted = restarted || started;
+        started = true;
+        startAddr = line.location;
+        blocks[0].startAddress = startAddr;
+        break;
+    case LineKind::USE:
+        emitted.push_back(EmittedLine{line.blockNumber, 0, 0, 0, ModificationRecord{0, 0}, true});
+        break;
+    case LineKind::BASE: {
+        if (line.operandId != NO_SYMBOL && resolved.find(line.operandId) == NO_HANDLE) {
+            pendingBases.push_back(PendingBase{line, base.pending, base.value});
+            base = BaseState{0, static_cast<int32_t>(pendingBases.size() - 1)};
+            break;
+        }
+        int value = 0;
+        if (encoder.resolveBase(line, value)) {
+            base = BaseState{value, -1};
+        } else {
+            Console::err() << "Error: Invalid BASE operand: " << line.operand << std::endl;
+        }
+        break;
+    }
+    case LineKind::NOBASE:
+        base = BaseState{-1, -1};
+        break;
+    case LineKind::END:
+        ended = true;
+        endLine = line;
+        break;
+    case LineKind::ORG:
+    case LineKind::LTORG:
+        break;
+    default:
+        lookahead = line;
+        hasLookahead = true;
+        break;
+    }
+
+    if (line.kind == LineKind::LITERAL) {
+        // processLTORG가 주소를 배정한 뒤에 넘어온다
+        wake(line.opcodeId);
+    } else if (line.labelId != NO_SYMBOL) {
+        define(line.labelId);
+    }
+}
+
+bool OnePassEncoder::finish(const Pass1 &pass1) {
+    if (hasLookahead) {
+        hasLookahead = false;
+        place(lookahead, lookahead.location);
+    }
+    if (!ended || restarted) {
+        Console::err() << "Error: One-pass mode needs a single START and an END directive" << std::endl;
+        return false;
+    }
+
+    // END에서 블록 배치와 SYMTAB 절대 주소가 확정되었으므로 남은 심볼을 모두 등록
+    blocks = pass1.getProgramBlocks();
+    layoutKnown = true;
+    for (size_t handle = 0; handle < symbols->size(); ++handle) {
+        const SymbolEntry &entry = symbols->at(static_cast<SymbolHandle>(handle));
+        if (resolved.find(entry.id) == NO_HANDLE) {
+            resolved.insert(entry.id, entry.address, entry.blockNumber);
+        }
+    }
+    for (const PendingBase &pending : pendingBases) {
+        int value = 0;
+        if (!encoder.resolveBase(pending.line, value)) {
+            Console::err() << "Error: Invalid BASE operand: " << pending.line.operand << std::endl;
+        }
+    }
+    for (size_t index = 0; index < fixups.size(); ++index) {
+        if (!fixups[index].done) {
+            resolveFixup(static_cast<int32_t>(index));
+        }
+    }
+    chains.clear();
+
+    // 레코드 조립은 Pass2와 같은 코드로 줄 순서대로
+    encoder.startAddr = pass1.getStartAddress();
+    encoder.programLength = pass1.getProgramLength();
+    encoder.programName = pass1.getProgramName();
+    encoder.firstExecAddr = encoder.startAddr;
+    encoder.makeHeaderRecord();
+    for (const EmittedLine &out : emitted) {
+        if (out.flush) {
+            encoder.flushTextRecord();
+            continue;
+        }
+        encoder.appendToTextRecord(
+            ObjectSpan{blocks.absoluteAddress(out.blockNumber, out.location), out.offset, out.length});
+        if (out.modification.length != 0) {
+            encoder.modificationRecords.push_back(out.modification);
+        }
+    }
+    encoder.flushTextRecord();
+    encoder.makeEndRecord(endLine);
+
+    Console::out() << "One-pass assembly completed: " << emitted.size() << " lines encoded, " << fixups.size()
+                   << " forward references patched" << std::endl;
+    return true;
+}
+
+void OnePassEncoder::writeObjFile(const std::string &objFilename) const {
+    encoder.writeObjFile(objFilename);
+}
+
+void OnePassEncoder::printObjFile() const {
+    encoder.printObjFile();
+}
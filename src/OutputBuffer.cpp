@@ -0,0 +1,144 @@
+#include "../include/assembler.h"
+#include <cerrno>
+#include <charconv>
+#include <cstdio>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <unistd.h>
+#define OUTPUTBUFFER_USE_POSIX 1
+#endif
+
+static const char HEX_DIGITS[] = "0123456789ABCDEF";
+
+OutputBuffer::OutputBuffer(size_t capacity) {
+    data.reserve(capacity);
+}
+
+void OutputBuffer::reserve(size_t capacity) {
+    data.reserve(capacity);
+}
+
+void OutputBuffer::appendField(const char *text, size_t length, size_t width, bool leftAlign, char fill) {
+    size_t padding = width > length ? width - length : 0;
+    if (!leftAlign) {
+        data.append(padding, fill);
+    }
+    data.append(text, length);
+    if (leftAlign) {
+        data.append(padding, fill);
+    }
+}
+
+void OutputBuffer::append(std::string_view text) {
+    data.append(text.data(), text.size());
+}
+
+void OutputBuffer::append(char c) {
+    data.push_back(c);
+}
+
+void OutputBuffer::appendRepeat(char c, size_t count) {
+    data.append(count, c);
+}
+
+void OutputBuffer::appendPadded(std::string_view text, size_t width, char fill) {
+    appendField(text.data(), text.size(), width, true, fill);
+}
+
+void OutputBuffer::appendHexFixed(uint32_t value, int digits) {
+    size_t start = data.size();
+    data.append(digits, '0');
+    for (int k = digits - 1; k >= 0; --k) {
+        data[start + k] = HEX_DIGITS[value & 0xF];
+        value >>= 4;
+    }
+}
+
+void OutputBuffer::appendHexBytes(const uint8_t *bytes, size_t count) {
+    size_t start = data.size();
+    data.resize(start + count * 2);
+    char *out = &data[start];
+    for (size_t k = 0; k < count; ++k) {
+        out[2 * k] = HEX_DIGITS[bytes[k] >> 4];
+        out[2 * k + 1] = HEX_DIGITS[bytes[k] & 0xF];
+    }
+}
+
+// iostream은 음수 int도 부호 없는 값으로 16진 출력한다
+void OutputBuffer::appendHexField(int value, size_t width, bool leftAlign, char fill) {
+    char digits[8];
+    uint32_t v = static_cast<uint32_t>(value);
+    int n = 0;
+    do {
+        digits[7 - n++] = HEX_DIGITS[v & 0xF];
+        v >>= 4;
+    } while (v != 0);
+    appendField(digits + 8 - n, n, width, leftAlign, fill);
+}
+
+void OutputBuffer::appendDecimalField(int value, size_t width, bool leftAlign, char fill) {
+    char digits[16];
+    auto res = std::to_chars(digits, digits + sizeof(digits), value);
+    appendField(digits, res.ptr - digits, width, leftAlign, fill);
+}
+
+std::string_view OutputBuffer::view() const {
+    return data;
+}
+
+size_t OutputBuffer::size() const {
+    return data.size();
+}
+
+void OutputBuffer::clear() {
+    data.clear();
+}
+
+bool OutputBuffer::writeTo(const std::string &filename) const {
+    return writeFile(filename, data);
+}
+
+// 임시 파일에 다 쓴 다음에만 원래 이름으로 바꾼다 (중간에 실패해도 이전 산출물이 남는다)
+bool OutputBuffer::writeFile(const std::string &filename, std::string_view data) {
+    std::string temporary = filename + ".tmp";
+    bool written = false;
+#ifdef OUTPUTBUFFER_USE_POSIX
+    int fd = ::open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        return false;
+    }
+    // 보통 write 한 번으로 끝나고, 부분 기록일 때만 나머지를 다시 쓴다
+    const char *p = data.data();
+    size_t left = data.size();
+    written = true;
+    while (left > 0) {
+        ssize_t count = ::write(fd, p, left);
+        if (count < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            written = false;
+            break;
+        }
+        p += count;
+        left -= static_cast<size_t>(count);
+    }
+    written = ::close(fd) == 0 && written;
+#else
+    {
+        std::ofstream file(temporary, std::ios::binary);
+        if (!file.is_open()) {
+            return false;
+        }
+        file.write(data.data(), static_cast<std::streamsize>(data.size()));
+        file.close();
+        written = static_cast<bool>(file);
+    }
+#endif
+    if (!written || std::rename(temporary.c_str(), filename.c_str()) != 0) {
+        std::remove(temporary.c_str());
+        return false;
+    }
+    return true;
+}
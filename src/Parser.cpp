@@ -1,134 +1,112 @@
 #include "../include/assembler.h"
+#include <charconv>
 
-SourceLine Parser::parseLine(const std::string &line) {
-    SourceLine result;
-    result.label = "";
-    result.opcode = "";
-    result.operand = "";
+// istream의 >> 와 동일한 공백 기준
+static inline bool isSpaceChar(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\v' || c == '\f' || c == '\r';
+}
+
+// pos부터 공백을 건너뛰고 다음 단어를 잘라낸다 (pos는 단어 끝으로 이동)
+static std::string_view nextToken(std::string_view line, size_t &pos) {
+    while (pos < line.size() && isSpaceChar(line[pos]))
+        pos++;
+    size_t begin = pos;
+    while (pos < line.size() && !isSpaceChar(line[pos]))
+        pos++;
+    return line.substr(begin, pos - begin);
+}
+
+SourceLine Parser::parseLine(std::string_view line) {
+    SourceLine result{};
     result.isFormat4 = false;
 
     if (line.empty() || line[0] == '#') {
         return result;
     }
-    std::istringstream iss(line);
-    std::string first, second;
+    size_t pos = 0;
 
     // 첫 번째 단어 읽기
-    iss >> first;
+    std::string_view first = nextToken(line, pos);
     if (first.empty())
         return result;
     // 라벨이 있는지 확인 (라인이 공백으로 시작하지 않으면 라벨)
     if (!startsWithWhitespace(line)) {
         result.label = first;
-        iss >> second;
-        result.opcode = second;
-        // 나머지는 operand
-        std::string rest;
-        std::getline(iss, rest);
-        result.operand = trim(rest);
+        result.opcode = nextToken(line, pos);
     } else {
         result.opcode = first;
-        // 나머지는 operand
-        std::string rest;
-        std::getline(iss, rest);
-        result.operand = trim(rest);
     }
+    // 나머지는 operand
+    result.operand = trim(line.substr(pos));
+
     // Format 4 체크 (opcode가 '+'로 시작)
     if (!result.opcode.empty() && result.opcode[0] == '+') {
         result.isFormat4 = true;
-        result.opcode = result.opcode.substr(1); // '+' 제거
+        result.opcode.remove_prefix(1); // '+' 제거
     }
     return result;
 }
 
-std::string Parser::trim(const std::string &str) {
-    size_t first = str.find_first_not_of(" \t\r\n");
-    if (first == std::string::npos)
-        return "";
-    size_t last = str.find_last_not_of(" \t\r\n");
-    return str.substr(first, (last - first + 1));
-}
-
-bool Parser::startsWithWhitespace(const std::string &line) {
-    return !line.empty() && (line[0] == ' ' || line[0] == '\t');
-}
-
-// 피연산자 파싱 (숫자 또는 심볼)
-int Parser::parseOperand(const std::string &operand, SYMTAB *symtab) {
-    std::string op = trim(operand);
-
-    // 16진수 체크 (0x 접두사)
-    if (op.size() > 2 && op.substr(0, 2) == "0x") {
-        return std::stoi(op.substr(2), nullptr, 16);
-    }
+// SourceScanner가 찾은 경계로 parseLine과 같은 결과를 만든다
+SourceLine Parser::parseFields(std::string_view buffer, const LineFields &fields) {
+    SourceLine result{};
+    result.isFormat4 = false;
 
-    // 숫자인지 확인
-    bool isNumber = true;
-    for (char c : op) {
-        if (!isdigit(c) && c != '-') {
-            isNumber = false;
-            break;
-        }
+    if (fields.flags & (LINE_COMMENT | LINE_BLANK)) {
+        return result;
     }
-
-    if (isNumber) {
-        return std::stoi(op);
+    auto slice = [&](uint32_t begin, uint32_t end) {
+        return buffer.substr(begin, end - begin);
+    };
+
+    if (fields.flags & LINE_LABELED) {
+        result.label = slice(fields.token[0], fields.tokenEnd[0]);
+        result.opcode = slice(fields.token[1], fields.tokenEnd[1]);
+        if (fields.token[2] < fields.contentEnd)
+            result.operand = slice(fields.token[2], fields.contentEnd);
+    } else {
+        result.opcode = slice(fields.token[0], fields.tokenEnd[0]);
+        if (fields.token[1] < fields.contentEnd)
+            result.operand = slice(fields.token[1], fields.contentEnd);
     }
 
-    // 심볼인 경우
-    if (symtab->exists(op)) {
-        return symtab->lookup(op);
+    if (!result.opcode.empty() && result.opcode[0] == '+') {
+        result.isFormat4 = true;
+        result.opcode.remove_prefix(1);
     }
-
-    std::cerr << "Error: Undefined symbol or invalid operand: " << op << std::endl;
-    return 0;
+    return result;
 }
 
-// 표현식 평가 (예: "BUFEND-BUFFER", "LENGTH+10", "MAXLEN-1")
-int Parser::evaluateExpression(const std::string &expr, SYMTAB *symtab) {
-    std::string expression = trim(expr);
-
-    // 연산자 찾기 (우선순위: +, -, *, /)
-    // 간단한 구현: 왼쪽에서 오른쪽으로 순차 처리
-
-    // + 또는 - 찾기 (낮은 우선순위)
-    for (size_t i = 1; i < expression.length(); i++) { // i=1부터 시작 (음수 방지)
-        if (expression[i] == '+' || expression[i] == '-') {
-            std::string left = expression.substr(0, i);
-            std::string right = expression.substr(i + 1);
+std::string_view Parser::trim(std::string_view str) {
+    size_t first = str.find_first_not_of(" \t\r\n\v\f");
+    if (first == std::string_view::npos)
+        return std::string_view();
+    size_t last = str.find_last_not_of(" \t\r\n\v\f");
+    return str.substr(first, (last - first + 1));
+}
 
-            int leftVal = evaluateExpression(left, symtab);
-            int rightVal = evaluateExpression(right, symtab);
+bool Parser::startsWithWhitespace(std::string_view line) {
+    return !line.empty() && (line[0] == ' ' || line[0] == '\t');
+}
 
-            if (expression[i] == '+') {
-                return leftVal + rightVal;
-            } else {
-                return leftVal - rightVal;
-            }
-        }
+// 숫자 문자열 전체를 정수로 변환 (16진수는 0x 접두사 허용)
+bool Parser::parseNumber(std::string_view text, int base, int &value) {
+    text = trim(text);
+    if (base == 16 && text.size() > 2 && text[0] == '0' && (text[1] == 'x' || text[1] == 'X')) {
+        text.remove_prefix(2);
     }
+    const char *end = text.data() + text.size();
+    auto res = std::from_chars(text.data(), end, value, base);
+    return res.ec == std::errc() && res.ptr == end;
+}
 
-    // * 또는 / 찾기 (높은 우선순위)
-    for (size_t i = 1; i < expression.length(); i++) {
-        if (expression[i] == '*' || expression[i] == '/') {
-            std::string left = expression.substr(0, i);
-            std::string right = expression.substr(i + 1);
-
-            int leftVal = evaluateExpression(left, symtab);
-            int rightVal = evaluateExpression(right, symtab);
-
-            if (expression[i] == '*') {
-                return leftVal * rightVal;
-            } else {
-                if (rightVal == 0) {
-                    std::cerr << "Error: Division by zero" << std::endl;
-                    return 0;
-                }
-                return leftVal / rightVal;
-            }
-        }
+// 표현식 평가 (예: "BUFEND-BUFFER", "LENGTH+10", "MAXLEN-1")
+// 캐시 없이 한 번 컴파일해서 평가한다 (Pass1은 ExpressionCache 사용)
+int Parser::evaluateExpression(std::string_view expr, SYMTAB *symtab) {
+    CompiledExpression compiled;
+    if (!compiled.compile(expr, symtab->getPool())) {
+        Console::err() << "Error: Invalid expression: " << expr << std::endl;
+        return 0;
     }
-
-    // 연산자가 없으면 단일 피연산자
-    return parseOperand(expression, symtab);
-}
\ No newline at end of file
+    return compiled.evaluate(symtab, 0);
+}
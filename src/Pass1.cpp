@@ -1,20 +1,85 @@
 #include "../include/assembler.h"
 
-Pass1::Pass1(OPTAB *opt, SYMTAB *sym, LITTAB *lit)
-    : optab(opt), symtab(sym), littab(lit), locctr(0), startAddr(0),
-      programName(""), currentBlock("DEFAULT"), blockCounter(0) {
-    initializeBlocks();
+const size_t Pass1::MIN_CHUNK_LINES;
+
+Pass1::Pass1(const OPTAB *opt, SYMTAB *sym, LITTAB *lit, SymbolPool *symbols, std::pmr::memory_resource *memory,
+             ThreadPool *threads)
+    : optab(opt), symtab(sym), littab(lit), pool(symbols), memory(memory), expressions(memory),
+      intFile(memory), locctr(0), startAddr(0), programName(""), currentBlock(0), workers(threads),
+      encoder(nullptr), incremental(false), sourceStates(memory), layoutLine(0), finished(false),
+      duplicateSymbols(false), rewound(false) {
+    literalLabel = pool->intern("*");
+
+    // 지시어 이름을 인터닝해 두고 ID로 바로 분류한다
+    static const std::pair<const char *, LineKind> DIRECTIVES[] = {
+        {"START", LineKind::START}, {"END", LineKind::END}, {"EQU", LineKind::EQU},
+        {"ORG", LineKind::ORG}, {"USE", LineKind::USE}, {"LTORG", LineKind::LTORG},
+        {"BASE", LineKind::BASE}, {"NOBASE", LineKind::NOBASE}, {"WORD", LineKind::WORD},
+        {"BYTE", LineKind::BYTE}, {"RESW", LineKind::RESW}, {"RESB", LineKind::RESB},
+    };
+    for (const auto &directive : DIRECTIVES) {
+        SymbolId id = pool->intern(directive.first);
+        if (id >= directiveKinds.size()) {
+            directiveKinds.resize(id + 1, LineKind::UNKNOWN);
+        }
+        directiveKinds[id] = directive.second;
+    }
+}
+
+// 위치/블록을 바꾸는 지시어가 명령어보다 우선, WORD/BYTE/RESW/RESB는 명령어가 우선
+LineKind Pass1::classify(SymbolId opcodeId) const {
+    LineKind directive = opcodeId < directiveKinds.size() ? directiveKinds[opcodeId] : LineKind::UNKNOWN;
+    switch (directive) {
+    case LineKind::WORD:
+    case LineKind::BYTE:
+    case LineKind::RESW:
+    case LineKind::RESB:
+    case LineKind::UNKNOWN:
+        return optab->isInstruction(opcodeId) ? LineKind::INSTRUCTION : directive;
+    default:
+        return directive;
+    }
 }
 
-void Pass1::initializeBlocks() {
-    ProgramBlock defaultBlock;
-    defaultBlock.name = "DEFAULT";
-    defaultBlock.number = 0;
-    defaultBlock.startAddress = 0;
-    defaultBlock.length = 0;
-    defaultBlock.currentLocctr = 0;
-    programBlocks["DEFAULT"] = defaultBlock;
-    blockCounter = 1;
+// 공유 상태를 바꾸지 않으므로 여러 스레드에서 동시에 호출할 수 있다
+// (SymbolPool은 읽기만 하고, 이 단계 동안에는 아무도 인터닝하지 않는다)
+void Pass1::prepareLine(std::string_view text, const LineFields &fields, PreparedLine &out) const {
+    out.fields = fields.begin == fields.end ? SourceLine{} : Parser::parseFields(text, fields);
+    out.opcodeId = out.fields.opcode.empty() ? NO_SYMBOL : pool->find(out.fields.opcode);
+    // 처음 보는 이름은 지시어도 명령어도 아니므로 ID 없이도 분류 결과가 같다
+    out.kind = classify(out.opcodeId);
+
+    std::string_view operand = out.fields.operand;
+    int count = 0;
+    switch (out.kind) {
+    case LineKind::INSTRUCTION:
+        out.length = out.fields.isFormat4 ? 4 : optab->getFormat(out.opcodeId);
+        break;
+    case LineKind::WORD:
+        out.length = 3;
+        break;
+    case LineKind::BYTE:
+        out.length = getByteLength(operand);
+        break;
+    case LineKind::RESW:
+    case LineKind::RESB:
+        // 10진 상수만 미리 계산하고 표현식은 순서대로 평가한다
+        if (operand.empty()) {
+            out.length = 0;
+        } else if (isdigit(static_cast<unsigned char>(operand[0])) && Parser::parseNumber(operand, 10, count)) {
+            out.length = out.kind == LineKind::RESW ? 3 * count : count;
+        } else {
+            out.length = UNKNOWN_LENGTH;
+        }
+        break;
+    case LineKind::UNKNOWN:
+        out.length = 0;
+        break;
+    default:
+        // 위치/블록을 바꾸는 지시어는 순서대로 처리
+        out.length = UNKNOWN_LENGTH;
+        break;
+    }
 }
 
 void Pass1::finalizeBlocks() {
@@ -23,285 +88,308 @@ void Pass1::finalizeBlocks() {
     programBlocks[currentBlock].length = locctr;
 
     // 2. 모든 블록의 length 확정
-    for (auto &blockPair : programBlocks) {
-        blockPair.second.length = blockPair.second.currentLocctr;
-    }
-
-    // 3. 블록 번호 순서대로 정렬
-    std::vector<ProgramBlock *> sortedBlocks(blockCounter);
-    for (auto &blockPair : programBlocks) {
-        sortedBlocks[blockPair.second.number] = &blockPair.second;
+    for (size_t number = 0; number < programBlocks.size(); ++number) {
+        ProgramBlock &block = programBlocks[number];
+        block.length = block.currentLocctr;
     }
 
-    // 4. 블록 번호순으로 시작 주소 계산
+    // 3. 블록 번호순으로 시작 주소 계산
     int currentAddr = startAddr;
-    for (ProgramBlock *blockPtr : sortedBlocks) {
-        if (blockPtr) {
-            blockPtr->startAddress = currentAddr;
-            currentAddr += blockPtr->length;
-
-            std::cout << "Block [" << blockPtr->number << "] " << blockPtr->name
-                      << ": Start=0x" << std::hex << std::uppercase << blockPtr->startAddress
-                      << ", Length=0x" << blockPtr->length << std::dec << std::endl;
-        }
-    }
-
-    // 5. SYMTAB의 심볼 주소를 절대 주소로 변환
-    std::vector<std::string> symbols = symtab->getAllSymbols();
-    for (const auto &symbol : symbols) {
-        int offset = symtab->lookup(symbol);
-        int blockNum = symtab->getBlockNumber(symbol);
-
-        for (const auto &blockPair : programBlocks) {
-            if (blockPair.second.number == blockNum) {
-                int absoluteAddr = blockPair.second.startAddress + offset;
-                symtab->updateAddress(symbol, absoluteAddr);
-                break;
-            }
-        }
-    }
-}
-
-int Pass1::getInstructionLength(const std::string &mnemonic, const std::string &operand) {
-    if (!optab->isInstruction(mnemonic)) {
-        return 0;
+    for (size_t number = 0; number < programBlocks.size(); ++number) {
+        ProgramBlock &block = programBlocks[number];
+        block.startAddress = currentAddr;
+        currentAddr += block.length;
+
+        Console::verbose() << "Block [" << block.number << "] " << block.name
+                           << ": Start=0x" << std::hex << std::uppercase << block.startAddress
+                           << ", Length=0x" << block.length << std::dec << std::endl;
     }
 
-    int format = optab->getFormat(mnemonic);
-
-    if (!operand.empty() && operand[0] == '+') {
-        return 4;
+    // 4. SYMTAB의 심볼 주소를 절대 주소로 변환
+    for (SymbolHandle symbol = 0; symbol < static_cast<SymbolHandle>(symtab->size()); ++symbol) {
+        const SymbolEntry &entry = symtab->at(symbol);
+        symtab->updateAddress(symbol, programBlocks.absoluteAddress(entry.blockNumber, entry.address));
     }
-
-    return format;
 }
 
-int Pass1::getDirectiveLength(const std::string &directive, const std::string &operand, SYMTAB *symtab) {
+int Pass1::getDirectiveLength(LineKind kind, std::string_view directive, std::string_view operand, SYMTAB *symtab) {
     int value = 0;
 
-    if (!operand.empty()) {
-        try {
-            value = Parser::evaluateExpression(operand, symtab);
-        } catch (const std::exception &) {
-            std::cerr << "Error: Invalid expression in directive "
-                      << directive << ": " << operand << std::endl;
+    // 값이 필요한 RESW/RESB만 표현식을 평가한다
+    if (!operand.empty() && (kind == LineKind::RESW || kind == LineKind::RESB)) {
+        if (!expressions.evaluate(operand, symtab, locctr, value)) {
+            Console::err() << "Error: Invalid expression in directive "
+                           << directive << ": " << operand << std::endl;
             value = 0;
         }
     }
 
-    if (directive == "WORD") {
+    switch (kind) {
+    case LineKind::WORD:
         return 3;
-    } else if (directive == "RESW") {
+    case LineKind::RESW:
         return 3 * value;
-    } else if (directive == "BYTE") {
-        if (operand.size() >= 3 && operand[0] == 'C' && operand[1] == '\'') {
-            size_t start = operand.find('\'');
-            size_t end = operand.rfind('\'');
-            if (start != std::string::npos && end != std::string::npos && end > start) {
-                return end - start - 1;
-            }
-        } else if (operand.size() >= 3 && operand[0] == 'X' && operand[1] == '\'') {
-            size_t start = operand.find('\'');
-            size_t end = operand.rfind('\'');
-            if (start != std::string::npos && end != std::string::npos && end > start) {
-                return (end - start - 1 + 1) / 2;
-            }
-        }
-    } else if (directive == "RESB") {
+    case LineKind::BYTE:
+        return getByteLength(operand);
+    case LineKind::RESB:
         return value;
-    } else if (directive == "EQU") {
+    default:
         return 0;
     }
+}
+
+int Pass1::getByteLength(std::string_view operand) {
+    if (operand.size() >= 3 && operand[0] == 'C' && operand[1] == '\'') {
+        size_t start = operand.find('\'');
+        size_t end = operand.rfind('\'');
+        if (start != std::string_view::npos && end != std::string_view::npos && end > start) {
+            return end - start - 1;
+        }
+    } else if (operand.size() >= 3 && operand[0] == 'X' && operand[1] == '\'') {
+        size_t start = operand.find('\'');
+        size_t end = operand.rfind('\'');
+        if (start != std::string_view::npos && end != std::string_view::npos && end > start) {
+            return (end - start - 1 + 1) / 2;
+        }
+    }
     return 0;
 }
 
 bool Pass1::execute(const std::string &srcFilename) {
-    std::ifstream file(srcFilename);
-    if (!file.is_open()) {
-        std::cerr << "Error: Cannot open source file: " << srcFilename << std::endl;
+    if (!source.open(srcFilename)) {
+        Console::err() << "Error: Cannot open source file: " << srcFilename << std::endl;
+        return false;
+    }
+    return executeSource(source.contents());
+}
+
+bool Pass1::executeSource(std::string_view text) {
+    intFile.setSource(text);
+    intFile.setTagged(incremental);
+    std::pmr::vector<LineFields> lines(memory);
+    if (!SourceScanner::scan(text, lines)) {
         return false;
     }
-    std::string line;
+
+    // 1단계 (병렬): 파싱, 분류, 길이 계산
+    std::pmr::vector<PreparedLine> prepared(lines.size(), PreparedLine(), memory);
+    size_t threadCount = workers ? workers->size() : 1;
+    size_t chunkLines = std::max(MIN_CHUNK_LINES, lines.size() / (threadCount * 4));
+    size_t chunkCount = (lines.size() + chunkLines - 1) / chunkLines;
+    auto prepareChunk = [&](size_t chunk) {
+        size_t end = std::min(lines.size(), (chunk + 1) * chunkLines);
+        for (size_t i = chunk * chunkLines; i < end; ++i) {
+            prepareLine(text, lines[i], prepared[i]);
+        }
+    };
+    if (workers) {
+        workers->run(chunkCount, prepareChunk);
+    } else {
+        for (size_t chunk = 0; chunk < chunkCount; ++chunk) {
+            prepareChunk(chunk);
+        }
+    }
+
+    // 2단계 (순서대로): 인터닝, 심볼/리터럴 등록, 위치 배정
+    // SymbolId는 처음 나온 순서로 정해지므로 이 단계는 라인 순서를 지켜야 한다
     int lineNum = 0;
 
-    while (std::getline(file, line)) {
+    for (const PreparedLine &line : prepared) {
         lineNum++;
-        if (line.empty())
-            continue;
-        SourceLine parsed = Parser::parseLine(line);
+        if (incremental) {
+            sourceStates.push_back(SourceState{intFile.nextTag(), locctr, currentBlock});
+        }
+        const SourceLine &parsed = line.fields;
         if (parsed.opcode.empty())
             continue;
+        SymbolId labelId = parsed.label.empty() ? NO_SYMBOL : pool->intern(parsed.label);
+        SymbolId opcodeId = line.opcodeId != NO_SYMBOL ? line.opcodeId : pool->intern(parsed.opcode);
+        LineKind kind = line.kind;
+        bool ended = false;
+        // 뒤쪽 주소가 바뀌면 값이 달라질 수 있는 줄 (증분 갱신에서 주소를 옮기기만 할 수 없다)
+        if (kind == LineKind::START || kind == LineKind::EQU || kind == LineKind::ORG ||
+            (line.length == UNKNOWN_LENGTH && (kind == LineKind::RESW || kind == LineKind::RESB))) {
+            layoutLine = lineNum;
+        }
+
+        switch (kind) {
         // START 처리
-        if (parsed.opcode == "START") {
+        case LineKind::START: {
             programName = parsed.label;
-            startAddr = std::stoi(parsed.operand, nullptr, 16);
+            if (!Parser::parseNumber(parsed.operand, 16, startAddr)) {
+                Console::err() << "Error at line " << lineNum
+                               << ": Invalid START address: " << parsed.operand << std::endl;
+                startAddr = 0;
+            }
             locctr = 0; // 블록 내부에서는 0부터 시작
             programBlocks[currentBlock].currentLocctr = 0;
 
             IntermediateLine intLine;
             intLine.location = startAddr; // START는 절대 주소 표시
-            intLine.label = parsed.label;
-            intLine.opcode = parsed.opcode;
+            intLine.labelId = labelId;
+            intLine.kind = kind;
+            intLine.opcodeId = opcodeId;
+            intLine.operandId = NO_SYMBOL;
             intLine.operand = parsed.operand;
-            intLine.objcode = "";
             intLine.hasLocation = true;
             intLine.isFormat4 = false;
-            intLine.blockNumber = programBlocks[currentBlock].number;
-            intFile.push_back(intLine);
+            intLine.blockNumber = currentBlock;
+            emit(intLine);
             continue;
         }
         // EQU 처리
-        if (parsed.opcode == "EQU") {
+        case LineKind::EQU: {
             if (parsed.label.empty()) {
-                std::cerr << "Error at line " << lineNum << ": EQU must have a label" << std::endl;
+                Console::err() << "Error at line " << lineNum << ": EQU must have a label" << std::endl;
                 continue;
             }
             int value = 0;
-            try {
-                value = Parser::evaluateExpression(parsed.operand, symtab);
-            } catch (const std::exception &e) {
-                std::cerr << "Error at line " << lineNum
-                          << ": Invalid expression for EQU: " << parsed.operand << std::endl;
+            if (!expressions.evaluate(parsed.operand, symtab, locctr, value)) {
+                Console::err() << "Error at line " << lineNum
+                               << ": Invalid expression for EQU: " << parsed.operand << std::endl;
                 continue;
             }
-            if (!symtab->insert(parsed.label, value, programBlocks[currentBlock].number)) {
-                std::cerr << "Warning at line " << lineNum
-                          << ": Duplicate symbol " << parsed.label << std::endl;
+            if (!symtab->insert(labelId, value, currentBlock)) {
+                Console::err() << "Warning at line " << lineNum
+                               << ": Duplicate symbol " << parsed.label << std::endl;
+                duplicateSymbols = true;
+            } else if (incremental) {
+                intFile.define(labelId, intFile.nextTag(), currentBlock, false);
             }
             IntermediateLine intLine;
             intLine.location = 0;
-            intLine.label = parsed.label;
-            intLine.opcode = parsed.opcode;
+            intLine.labelId = labelId;
+            intLine.kind = kind;
+            intLine.opcodeId = opcodeId;
+            intLine.operandId = NO_SYMBOL;
             intLine.operand = parsed.operand;
-            intLine.objcode = "";
             intLine.hasLocation = false;
             intLine.isFormat4 = false;
-            intLine.blockNumber = programBlocks[currentBlock].number;
-            intFile.push_back(intLine);
+            intLine.blockNumber = currentBlock;
+            emit(intLine);
             continue;
         }
         // ORG 처리
-        if (parsed.opcode == "ORG") {
+        case LineKind::ORG: {
             int newLoc = 0;
 
-            try {
-                newLoc = Parser::evaluateExpression(parsed.operand, symtab);
-            } catch (const std::exception &e) {
-                std::cerr << "Error at line " << lineNum
-                          << ": Invalid operand for ORG " << parsed.operand << std::endl;
+            if (!expressions.evaluate(parsed.operand, symtab, locctr, newLoc)) {
+                Console::err() << "Error at line " << lineNum
+                               << ": Invalid operand for ORG " << parsed.operand << std::endl;
                 continue;
             }
 
+            rewound = rewound || newLoc < locctr;
             locctr = newLoc;
             programBlocks[currentBlock].currentLocctr = locctr;
 
             IntermediateLine intLine;
             intLine.location = locctr;
-            intLine.label = parsed.label;
-            intLine.opcode = parsed.opcode;
+            intLine.labelId = labelId;
+            intLine.kind = kind;
+            intLine.opcodeId = opcodeId;
+            intLine.operandId = NO_SYMBOL;
             intLine.operand = parsed.operand;
-            intLine.objcode = "";
             intLine.hasLocation = true;
             intLine.isFormat4 = false;
-            intLine.blockNumber = programBlocks[currentBlock].number;
-            intFile.push_back(intLine);
+            intLine.blockNumber = currentBlock;
+            emit(intLine);
 
             continue;
         }
         // USE 지시어 처리 (Program Blocks)
-        if (parsed.opcode == "USE") {
+        case LineKind::USE: {
             // 현재 블록의 최종 위치 저장
             programBlocks[currentBlock].currentLocctr = locctr;
 
-            // 새 블록 이름 (비어있으면 DEFAULT)
-            std::string newBlock = parsed.operand.empty() ? "DEFAULT" : parsed.operand;
-
-            // 새 블록이 없으면 생성
-            if (programBlocks.find(newBlock) == programBlocks.end()) {
-                ProgramBlock newProgramBlock;
-                newProgramBlock.name = newBlock;
-                newProgramBlock.number = blockCounter++;
-                newProgramBlock.startAddress = 0;
-                newProgramBlock.length = 0;
-                newProgramBlock.currentLocctr = 0;
-                programBlocks[newBlock] = newProgramBlock;
-            }
-
-            // 블록 전환
-            currentBlock = newBlock;
+            // 블록 전환 (이름이 비어있으면 DEFAULT, 없으면 새로 생성)
+            currentBlock = programBlocks.use(parsed.operand.empty() ? std::string_view("DEFAULT") : parsed.operand);
             locctr = programBlocks[currentBlock].currentLocctr; // 해당 블록의 현재 위치로 복원
 
             IntermediateLine intLine;
             intLine.location = locctr;
-            intLine.label = parsed.label;
-            intLine.opcode = parsed.opcode;
+            intLine.labelId = labelId;
+            intLine.kind = kind;
+            intLine.opcodeId = opcodeId;
+            intLine.operandId = NO_SYMBOL;
             intLine.operand = parsed.operand;
-            intLine.objcode = "";
             intLine.hasLocation = false;
             intLine.isFormat4 = false;
-            intLine.blockNumber = programBlocks[currentBlock].number;
-            intFile.push_back(intLine);
+            intLine.blockNumber = currentBlock;
+            emit(intLine);
 
             continue;
         }
         // LTORG 처리
-        if (parsed.opcode == "LTORG") {
+        case LineKind::LTORG: {
             processLTORG();
             IntermediateLine intLine;
             intLine.location = 0;
-            intLine.label = parsed.label;
-            intLine.opcode = parsed.opcode;
+            intLine.labelId = labelId;
+            intLine.kind = kind;
+            intLine.opcodeId = opcodeId;
+            intLine.operandId = NO_SYMBOL;
             intLine.operand = parsed.operand;
-            intLine.objcode = "";
             intLine.hasLocation = false;
             intLine.isFormat4 = false;
-            intLine.blockNumber = programBlocks[currentBlock].number;
-            intFile.push_back(intLine);
+            intLine.blockNumber = currentBlock;
+            emit(intLine);
 
             continue;
         }
         // BASE 지시어 처리
-        if (parsed.opcode == "BASE") {
+        case LineKind::BASE: {
             IntermediateLine intLine;
             intLine.location = 0;
-            intLine.label = parsed.label;
-            intLine.opcode = parsed.opcode;
+            intLine.labelId = labelId;
+            intLine.kind = kind;
+            intLine.opcodeId = opcodeId;
+            intLine.operandId = internOperand(parsed.operand);
             intLine.operand = parsed.operand;
-            intLine.objcode = "";
             intLine.hasLocation = false;
             intLine.isFormat4 = false;
-            intLine.blockNumber = programBlocks[currentBlock].number;
-            intFile.push_back(intLine);
+            intLine.blockNumber = currentBlock;
+            emit(intLine);
             continue;
         }
         // NOBASE 지시어 처리
-        if (parsed.opcode == "NOBASE") {
+        case LineKind::NOBASE: {
             IntermediateLine intLine;
             intLine.location = 0;
-            intLine.label = parsed.label;
-            intLine.opcode = parsed.opcode;
+            intLine.labelId = labelId;
+            intLine.kind = kind;
+            intLine.opcodeId = opcodeId;
+            intLine.operandId = NO_SYMBOL;
             intLine.operand = parsed.operand;
-            intLine.objcode = "";
             intLine.hasLocation = false;
             intLine.isFormat4 = false;
-            intLine.blockNumber = programBlocks[currentBlock].number;
-            intFile.push_back(intLine);
+            intLine.blockNumber = currentBlock;
+            emit(intLine);
             continue;
         }
         // END 처리
-        if (parsed.opcode == "END") {
+        case LineKind::END: {
             processLTORG();
             finalizeBlocks();
             IntermediateLine intLine;
             intLine.location = 0;
-            intLine.label = parsed.label;
-            intLine.opcode = parsed.opcode;
+            intLine.labelId = labelId;
+            intLine.kind = kind;
+            intLine.opcodeId = opcodeId;
+            intLine.operandId = internOperand(parsed.operand);
             intLine.operand = parsed.operand;
-            intLine.objcode = "";
             intLine.hasLocation = false;
             intLine.isFormat4 = false;
-            intLine.blockNumber = programBlocks[currentBlock].number;
-            intFile.push_back(intLine);
+            intLine.blockNumber = currentBlock;
+            emit(intLine);
+            ended = true;
+            finished = true;
+            break;
+        }
+        default:
+            break;
+        }
+        if (ended) {
             break;
         }
 
@@ -309,23 +397,26 @@ bool Pass1::execute(const std::string &srcFilename) {
         int currentLoc = locctr;
         // 라벨이 있으면 SYMTAB에 추가 (블록 내 상대 주소로)
         if (!parsed.label.empty()) {
-            if (!symtab->insert(parsed.label, currentLoc, programBlocks[currentBlock].number)) {
-                std::cerr << "Warning at line " << lineNum
-                          << ": Duplicate symbol " << parsed.label << std::endl;
+            if (!symtab->insert(labelId, currentLoc, currentBlock)) {
+                Console::err() << "Warning at line " << lineNum
+                               << ": Duplicate symbol " << parsed.label << std::endl;
+                duplicateSymbols = true;
+            } else if (incremental) {
+                intFile.define(labelId, intFile.nextTag(), currentBlock, true);
             }
         }
 
         // 리터럴 검사
         if (!parsed.operand.empty() && parsed.operand[0] == '=') {
-            std::string op = parsed.operand;
+            std::string_view op = parsed.operand;
 
             size_t comma = op.find(',');
-            if (comma != std::string::npos) {
+            if (comma != std::string_view::npos) {
                 op = op.substr(0, comma);
             }
 
             if (op[0] == '#' || op[0] == '@') {
-                op = op.substr(1);
+                op.remove_prefix(1);
             }
 
             if (op[0] == '=') {
@@ -333,153 +424,390 @@ bool Pass1::execute(const std::string &srcFilename) {
             }
         }
 
-        // 명령어 길이 계산
-        int length = 0;
-        if (optab->isInstruction(parsed.opcode)) {
-            if (parsed.isFormat4) {
-                length = 4;
-            } else {
-                int format = optab->getFormat(parsed.opcode);
-                length = format;
-            }
-        } else {
-            length = getDirectiveLength(parsed.opcode, parsed.operand, symtab);
+        // 명령어 길이 (준비 단계에서 못 정한 표현식 RESW/RESB만 여기서 평가)
+        int length = line.length;
+        if (length == UNKNOWN_LENGTH) {
+            length = getDirectiveLength(kind, parsed.opcode, parsed.operand, symtab);
         }
 
         // 중간파일에 추가 (블록 내 상대 주소로)
         IntermediateLine intLine;
         intLine.location = currentLoc;
-        intLine.label = parsed.label;
-        intLine.opcode = parsed.opcode;
+        intLine.labelId = labelId;
+        intLine.kind = kind;
+        intLine.opcodeId = opcodeId;
+        // 형식 3/4 명령어와 WORD만 피연산자로 심볼/리터럴을 참조한다
+        bool refersToSymbol = kind == LineKind::INSTRUCTION ? optab->getFormat(opcodeId) == 3
+                                                             : kind == LineKind::WORD;
+        intLine.operandId = refersToSymbol ? internOperand(parsed.operand) : NO_SYMBOL;
         intLine.operand = parsed.operand;
-        intLine.objcode = "";
         intLine.hasLocation = true;
         intLine.isFormat4 = parsed.isFormat4;
-        intLine.blockNumber = programBlocks[currentBlock].number;
-        intFile.push_back(intLine);
+        intLine.blockNumber = currentBlock;
+        emit(intLine);
 
         // LOCCTR 증가 (블록별로 독립적으로 관리)
         locctr += length;
         programBlocks[currentBlock].currentLocctr = locctr;
     }
 
-    file.close();
-    std::cout << "Pass 1 completed: " << lineNum << " lines processed" << std::endl;
+    Console::out() << "Pass 1 completed: " << lineNum << " lines processed" << std::endl;
     return true;
 }
 
-void Pass1::processLTORG() {
-    std::vector<Literal> unassigned = littab->getUnassignedLiterals();
+void Pass1::setEncoder(OnePassEncoder *target) {
+    encoder = target;
+}
+
+void Pass1::setIncremental(bool enabled) {
+    incremental = enabled;
+}
+
+// 증분으로 처리할 수 있는 줄: 위치 카운터만 늘리는 명령어/데이터와 BASE/NOBASE
+static bool isPlainLine(LineKind kind) {
+    switch (kind) {
+    case LineKind::INSTRUCTION:
+    case LineKind::WORD:
+    case LineKind::BYTE:
+    case LineKind::RESW:
+    case LineKind::RESB:
+    case LineKind::BASE:
+    case LineKind::NOBASE:
+    case LineKind::UNKNOWN:
+        return true;
+    default:
+        return false;
+    }
+}
+
+static bool isLiteralOperand(std::string_view operand) {
+    return !operand.empty() && operand[0] == '=';
+}
+
+// 상태가 가리키는 중간 코드 줄과 같은 만큼 움직인 위치
+int Pass1::stateLocation(const SourceState &state) const {
+    return state.location + intFile.locationShift(state.block, state.tag);
+}
 
-    for (const auto &lit : unassigned) {
-        littab->assignAddress(lit.name, locctr);
+// 바뀐 범위 앞뒤 줄이 모두 같은 블록이고, 지우는 줄과 새 줄이 모두 평범한 줄이며,
+// 길이가 바뀌면 뒤쪽에 다시 계산해야 하는 줄(EQU, ORG, 표현식 RESW/RESB 등)이 없어야 한다
+bool Pass1::canUpdate(size_t firstLine, size_t removedLines, const std::pmr::vector<PreparedLine> &prepared) const {
+    if (!incremental || !finished || duplicateSymbols || firstLine + removedLines >= sourceStates.size()) {
+        return false;
+    }
+    const SourceState &first = sourceStates[firstLine];
+    const SourceState &last = sourceStates[firstLine + removedLines];
+    if (first.block != last.block) {
+        return false;
+    }
+    size_t begin = intFile.indexOf(first.tag);
+    size_t end = intFile.indexOf(last.tag);
+
+    std::unordered_map<std::string_view, bool> labels; // 이름 → 이전 줄의 라벨이면 true
+    for (size_t i = begin; i < end; ++i) {
+        IntermediateLine line = intFile.at(i);
+        if (!isPlainLine(line.kind) || isLiteralOperand(line.operand)) {
+            return false;
+        }
+        if (line.labelId != NO_SYMBOL && line.kind != LineKind::BASE && line.kind != LineKind::NOBASE) {
+            labels[pool->name(line.labelId)] = true;
+        }
+    }
 
+    int length = 0;
+    size_t lines = 0;
+    for (const PreparedLine &line : prepared) {
+        const SourceLine &parsed = line.fields;
+        if (parsed.opcode.empty()) {
+            continue;
+        }
+        bool base = line.kind == LineKind::BASE || line.kind == LineKind::NOBASE;
+        if (!isPlainLine(line.kind) || isLiteralOperand(parsed.operand) || (!base && line.length == UNKNOWN_LENGTH)) {
+            return false;
+        }
+        if (!base && !parsed.label.empty()) {
+            // 중복 라벨은 경고를 내야 하므로 전체를 다시 처리한다
+            auto it = labels.find(parsed.label);
+            if (it != labels.end() ? !it->second : symtab->exists(pool->find(parsed.label))) {
+                return false;
+            }
+            labels[parsed.label] = false;
+        }
+        if (!base) {
+            length += line.length;
+        }
+        ++lines;
+    }
+    // 한 자리에 줄을 아주 많이 끼워 태그 간격이 바닥나면 전체를 다시 처리해 태그를 새로 붙인다
+    if (!intFile.canReplace(begin, end - begin, lines)) {
+        return false;
+    }
+    // 길이가 바뀌면 Pass2가 편집 근처만 훑어 변위가 바뀌는 줄을 찾으므로 블록 안 위치가 줄 순서대로 커져야 한다
+    bool resized = length != stateLocation(last) - stateLocation(first);
+    return !resized || (layoutLine <= firstLine + removedLines && !rewound);
+}
+
+bool Pass1::update(std::string_view text, const SourceEdit &edit, IntermediateEdit &out) {
+    std::string_view region = text.substr(edit.beginByte, edit.newBytes);
+    std::pmr::vector<LineFields> lines(memory);
+    if (!incremental || !SourceScanner::scan(region, lines)) {
+        return false;
+    }
+    std::pmr::vector<PreparedLine> prepared(lines.size(), PreparedLine(), memory);
+    for (size_t i = 0; i < lines.size(); ++i) {
+        prepareLine(region, lines[i], prepared[i]);
+    }
+    if (!canUpdate(edit.firstLine, edit.removedLines, prepared)) {
+        return false;
+    }
+
+    size_t editEnd = edit.firstLine + edit.removedLines;
+    int block = sourceStates[edit.firstLine].block;
+    int startLocation = stateLocation(sourceStates[edit.firstLine]);
+    int endLocation = stateLocation(sourceStates[editEnd]);
+    out.begin = intFile.indexOf(sourceStates[edit.firstLine].tag);
+    out.removed = intFile.indexOf(sourceStates[editEnd].tag) - out.begin;
+    out.block = block;
+    out.location = startLocation;
+    out.baseChanged = false;
+    out.redefined.clear();
+    out.released.clear();
+
+    // 1. 이전 줄이 정의한 심볼 삭제
+    for (size_t i = out.begin; i < out.begin + out.removed; ++i) {
+        IntermediateLine line = intFile.at(i);
+        if (line.operandId != NO_SYMBOL) {
+            out.released.emplace_back(intFile.tag(i), line.operandId);
+        }
+        if (line.kind == LineKind::BASE || line.kind == LineKind::NOBASE) {
+            out.baseChanged = true;
+        } else if (line.labelId != NO_SYMBOL) {
+            symtab->erase(line.labelId);
+            intFile.undefine(line.labelId);
+            out.redefined.push_back(line.labelId);
+        }
+    }
+
+    // 2. 새 줄 처리 (execute의 같은 종류 줄과 같은 중간 코드)
+    std::vector<IntermediateLine> added;
+    std::vector<std::pair<size_t, int>> starts; // 소스 줄마다 (그 줄 이후 첫 새 줄, 위치)
+    int location = startLocation;
+    for (const PreparedLine &line : prepared) {
+        starts.emplace_back(added.size(), location);
+        const SourceLine &parsed = line.fields;
+        if (parsed.opcode.empty()) {
+            continue;
+        }
         IntermediateLine intLine;
-        intLine.location = locctr;
-        intLine.label = "*";
-        intLine.opcode = lit.name;
-        intLine.operand = lit.value;
-        intLine.objcode = "";
+        intLine.kind = line.kind;
+        intLine.labelId = parsed.label.empty() ? NO_SYMBOL : pool->intern(parsed.label);
+        intLine.opcodeId = line.opcodeId != NO_SYMBOL ? line.opcodeId : pool->intern(parsed.opcode);
+        intLine.operand = parsed.operand;
+        intLine.blockNumber = block;
+
+        if (line.kind == LineKind::BASE || line.kind == LineKind::NOBASE) {
+            out.baseChanged = true;
+            intLine.location = 0;
+            intLine.operandId = line.kind == LineKind::BASE ? internOperand(parsed.operand) : NO_SYMBOL;
+            intLine.hasLocation = false;
+            intLine.isFormat4 = false;
+            added.push_back(intLine);
+            continue;
+        }
+        bool refersToSymbol = line.kind == LineKind::INSTRUCTION ? optab->getFormat(intLine.opcodeId) == 3
+                                                                  : line.kind == LineKind::WORD;
+        intLine.location = location;
+        intLine.operandId = refersToSymbol ? internOperand(parsed.operand) : NO_SYMBOL;
         intLine.hasLocation = true;
-        intLine.isFormat4 = false;
-        intLine.blockNumber = programBlocks[currentBlock].number;
-        intFile.push_back(intLine);
+        intLine.isFormat4 = parsed.isFormat4;
+        added.push_back(intLine);
+        location += line.length;
+    }
 
-        locctr += lit.length;
-        programBlocks[currentBlock].currentLocctr = locctr;
+    // 3. 중간 코드 교체, 새 라벨 등록 (SYMTAB에는 미뤄 둔 이동을 뺀 절대 주소)
+    intFile.replace(out.begin, out.removed, added);
+    out.inserted = added.size();
+    for (size_t j = 0; j < added.size(); ++j) {
+        const IntermediateLine &line = added[j];
+        if (line.labelId == NO_SYMBOL || !line.hasLocation) {
+            continue;
+        }
+        intFile.define(line.labelId, intFile.tag(out.begin + j), block, true);
+        symtab->insert(line.labelId,
+                       programBlocks.absoluteAddress(block, line.location) - intFile.symbolShift(line.labelId, block),
+                       block);
+        out.redefined.push_back(line.labelId);
     }
-}
 
-const std::map<std::string, ProgramBlock> &Pass1::getProgramBlocks() const {
-    return programBlocks;
-}
+    // 4. 뒤쪽 줄/심볼/리터럴은 고쳐 쓰지 않고 이동만 기록 (블록 길이와 시작 주소는 바로 고친다)
+    out.shift = location - endLocation;
+    if (out.shift != 0) {
+        intFile.shiftLocations(out.begin + out.inserted, block, out.shift, programBlocks.size());
+        programBlocks[block].length += out.shift;
+        programBlocks[block].currentLocctr += out.shift;
+        for (size_t number = block + 1; number < programBlocks.size(); ++number) {
+            programBlocks[static_cast<int>(number)].startAddress += out.shift;
+        }
+        if (currentBlock == block) {
+            locctr += out.shift;
+        }
+    }
 
-int Pass1::getProgramLength() const {
-    int totalLength = 0;
-    for (const auto &blockPair : programBlocks) {
-        totalLength += blockPair.second.length;
+    // 5. 소스 줄 상태 교체 (END 앞까지만 편집하므로 범위 뒤에는 항상 줄이 있다)
+    uint64_t after = intFile.tag(out.begin + out.inserted);
+    auto stateAt = [&](size_t next, int at) {
+        uint64_t tag = next < out.inserted ? intFile.tag(out.begin + next) : after;
+        return SourceState{tag, at - intFile.locationShift(block, tag), block};
+    };
+    // 바로 앞의 빈 줄/주석 줄은 바뀐 범위의 첫 줄을 가리키고 있었다
+    uint64_t before = out.begin > 0 ? intFile.tag(out.begin - 1) : 0;
+    for (size_t k = edit.firstLine; k-- > 0 && sourceStates[k].tag > before;) {
+        sourceStates[k] = stateAt(0, startLocation);
+    }
+    size_t reused = std::min(edit.removedLines, starts.size());
+    for (size_t k = 0; k < reused; ++k) {
+        sourceStates[edit.firstLine + k] = stateAt(starts[k].first, starts[k].second);
     }
-    return totalLength;
+    if (edit.removedLines > reused) {
+        sourceStates.erase(sourceStates.begin() + edit.firstLine + reused, sourceStates.begin() + editEnd);
+    } else {
+        std::vector<SourceState> states;
+        for (size_t k = reused; k < starts.size(); ++k) {
+            states.push_back(stateAt(starts[k].first, starts[k].second));
+        }
+        sourceStates.insert(sourceStates.begin() + editEnd, states.begin(), states.end());
+    }
+    if (layoutLine > editEnd) {
+        layoutLine = layoutLine + prepared.size() - edit.removedLines;
+    } else if (layoutLine > edit.firstLine) {
+        layoutLine = edit.firstLine;
+    }
+
+    if (intFile.pendingShifts() > MAX_PENDING_SHIFTS) {
+        settle();
+    }
+    return true;
 }
 
-void Pass1::writeIntFile(const std::string &intFilename) {
-    std::ofstream file(intFilename);
-    if (!file.is_open()) {
-        std::cerr << "Error: Cannot write intermediate file" << std::endl;
+void Pass1::settle() {
+    if (intFile.pendingShifts() == 0) {
         return;
     }
+    for (SourceState &state : sourceStates) {
+        state.location = stateLocation(state);
+    }
+    for (SymbolHandle symbol = 0; symbol < static_cast<SymbolHandle>(symtab->size()); ++symbol) {
+        const SymbolEntry &entry = symtab->at(symbol);
+        int shift = intFile.symbolShift(entry.id, entry.blockNumber);
+        if (shift != 0) {
+            symtab->updateAddress(symbol, entry.address + shift);
+        }
+    }
+    for (LiteralHandle literal = 0; literal < static_cast<LiteralHandle>(littab->size()); ++literal) {
+        const Literal &lit = littab->at(literal);
+        int shift = lit.assigned ? intFile.literalShift(lit.id) : 0;
+        if (shift != 0) {
+            littab->assignAddress(literal, lit.address + shift);
+        }
+    }
+    intFile.settle();
+}
 
-    for (const auto &line : intFile) {
-        // START는 절대 주소로 표시, 나머지는 절대 주소 계산하여 표시
-        if (line.hasLocation) {
-            int absAddr;
-            if (line.opcode == "START") {
-                // START는 원래 저장된 주소 사용
-                absAddr = line.location;
-            } else {
-                // 블록의 시작 주소 찾기
-                int blockStartAddr = 0;
-                for (const auto &blockPair : programBlocks) {
-                    if (blockPair.second.number == line.blockNumber) {
-                        blockStartAddr = blockPair.second.startAddress;
-                        break;
-                    }
-                }
-                // 절대 주소 = 블록 시작 주소 + 블록 내 상대 주소
-                absAddr = blockStartAddr + line.location;
-            }
+void Pass1::emit(const IntermediateLine &line) {
+    if (encoder) {
+        encoder->line(line);
+    } else {
+        intFile.push(line);
+    }
+}
 
-            file << "0x" << std::hex << std::uppercase
-                 << std::setw(4) << std::setfill('0') << absAddr << "  ";
-        } else {
-            file << "          ";
+// 피연산자가 참조하는 심볼/리터럴 이름을 인터닝 (#, @, ,X 제거, 숫자는 제외)
+SymbolId Pass1::internOperand(std::string_view operand) {
+    if (!operand.empty() && (operand[0] == '#' || operand[0] == '@')) {
+        operand.remove_prefix(1);
+    }
+    size_t comma = operand.find(",X");
+    if (comma != std::string_view::npos) {
+        operand = Parser::trim(operand.substr(0, comma));
+    }
+    if (operand.empty() || isdigit(static_cast<unsigned char>(operand[0])) || operand[0] == '-') {
+        return NO_SYMBOL;
+    }
+    return pool->intern(operand);
+}
+
+void Pass1::processLTORG() {
+    // 마지막 LTORG 이후 추가된 리터럴만 배치
+    for (LiteralHandle handle : littab->takePendingPool()) {
+        littab->assignAddress(handle, locctr);
+        const Literal &lit = littab->at(handle);
+        if (incremental) {
+            intFile.define(lit.id, intFile.nextTag(), currentBlock, true);
         }
 
-        file << std::left << std::setfill(' ')
-             << std::setw(10) << line.label
-             << std::setw(10) << line.opcode
-             << std::setw(20) << line.operand
-             << line.objcode << std::endl;
+        IntermediateLine intLine;
+        intLine.location = locctr;
+        intLine.kind = LineKind::LITERAL;
+        intLine.labelId = literalLabel;
+        intLine.opcodeId = lit.id;
+        intLine.operandId = lit.id;
+        intLine.operand = lit.value;
+        intLine.hasLocation = true;
+        intLine.isFormat4 = false;
+        intLine.blockNumber = currentBlock;
+        emit(intLine);
+
+        locctr += lit.length;
+        programBlocks[currentBlock].currentLocctr = locctr;
     }
+}
+
+const BlockTable &Pass1::getProgramBlocks() const {
+    return programBlocks;
+}
+
+int Pass1::getProgramLength() const {
+    return programBlocks.totalLength();
+}
 
-    file.close();
-    std::cout << "Intermediate file written: " << intFilename << std::endl;
+bool Pass1::writeIntFile(const std::string &intFilename) const {
+    return IntermediateFile::writeText(intFilename, intFile, programBlocks, *pool);
 }
 
 void Pass1::printIntFile() const {
-    std::cout << "\n"
-              << std::string(80, '=') << std::endl;
-    std::cout << "INTERMEDIATE FILE (INTFILE)" << std::endl;
-    std::cout << std::string(80, '=') << std::endl;
-    std::cout << std::left
-              << std::setw(10) << "LOC"
-              << std::setw(10) << "LABEL"
-              << std::setw(10) << "OPCODE"
-              << std::setw(20) << "OPERAND"
-              << "OBJCODE" << std::endl;
-    std::cout << std::string(80, '-') << std::endl;
-
-    for (const auto &line : intFile) {
+    Console::out() << "\n"
+                   << std::string(80, '=') << std::endl;
+    Console::out() << "INTERMEDIATE FILE (INTFILE)" << std::endl;
+    Console::out() << std::string(80, '=') << std::endl;
+    Console::out() << std::left
+                   << std::setw(10) << "LOC"
+                   << std::setw(10) << "LABEL"
+                   << std::setw(10) << "OPCODE"
+                   << std::setw(20) << "OPERAND"
+                   << "OBJCODE" << std::endl;
+    Console::out() << std::string(80, '-') << std::endl;
+
+    for (size_t i = 0; i < intFile.size(); ++i) {
+        IntermediateLine line = intFile.at(i);
         // START는 절대 주소로 표시, 나머지는 블록 내 상대 주소로 표시
         if (line.hasLocation) {
-            if (line.opcode == "START") {
-                std::cout << "0x" << std::hex << std::uppercase
-                          << std::setw(4) << std::setfill('0') << line.location << "  ";
+            if (line.kind == LineKind::START) {
+                Console::out() << "0x" << std::hex << std::uppercase
+                               << std::setw(4) << std::setfill('0') << line.location << "  ";
             } else {
-                std::cout << "0x" << std::hex << std::uppercase
-                          << std::setw(4) << std::setfill('0') << line.location << "  ";
+                Console::out() << "0x" << std::hex << std::uppercase
+                               << std::setw(4) << std::setfill('0') << line.location << "  ";
             }
         } else {
-            std::cout << "          ";
+            Console::out() << "          ";
         }
 
-        std::cout << std::dec << std::left << std::setfill(' ')
-                  << std::setw(10) << line.label
-                  << std::setw(10) << line.opcode
-                  << std::setw(20) << line.operand
-                  << line.objcode << std::endl;
+        Console::out() << std::dec << std::left << std::setfill(' ')
+                       << std::setw(10) << pool->name(line.labelId)
+                       << std::setw(10) << pool->name(line.opcodeId)
+                       << std::setw(20) << line.operand << std::endl;
     }
-    std::cout << std::string(80, '=') << std::endl;
+    Console::out() << std::string(80, '=') << std::endl;
 }
 
 int Pass1::getStartAddress() const {
@@ -490,7 +818,7 @@ int Pass1::getFinalLocctr() const {
     return locctr;
 }
 
-const std::vector<IntermediateLine> &Pass1::getIntFile() const {
+const IntermediateCode &Pass1::getIntFile() const {
     return intFile;
 }
 
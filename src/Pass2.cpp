@@ -1,15 +1,24 @@
 #include "../include/assembler.h"
-
-Pass2::Pass2(OPTAB *opt, SYMTAB *sym, LITTAB *lit,
-             const std::vector<IntermediateLine> &intF,
+#include <charconv>
+
+const size_t Pass2::MIN_CHUNK_LINES;
+const size_t Pass2::STREAM_WINDOW_PER_THREAD;
+const uint8_t Pass2::WATCH_REMOTE;
+const uint8_t Pass2::WATCH_CROSS;
+const uint8_t Pass2::WATCH_DIRECT;
+const uint8_t Pass2::WATCH_ABSOLUTE;
+const int Pass2::NEAR_WINDOW;
+
+Pass2::Pass2(const OPTAB *opt, SYMTAB *sym, LITTAB *lit, SymbolPool *symbols,
+             const IntermediateCode &intF,
              int start, int length, const std::string &progName,
-             const std::map<std::string, ProgramBlock> &blocks)
-    : optab(opt), symtab(sym), littab(lit), intFile(intF), startAddr(start),
-      programLength(length), programName(progName), firstExecAddr(start),
-      currentTextRecordStartAddr(0), currentTextRecordLength(0),
-      baseRegister(-1), programBlocks(blocks),
-      currentBlockName("DEFAULT"),
-      currentBlockStartAddr(start) {
+             const BlockTable &blocks, std::pmr::memory_resource *memory, ThreadPool *threads)
+    : optab(opt), symtab(sym), littab(lit), pool(symbols), intFile(intF),
+      startAddr(start), programLength(length), programName(progName), firstExecAddr(start),
+      baseRegister(-1), programBlocks(blocks), workers(threads), objectBytes(memory), lineCode(memory),
+      lineModifications(memory), textRecords(memory), modificationRecords(memory), currentText{0, 0, 0}, tracking(false), references(memory), baseLines(memory),
+      remoteLines(memory), crossLines(memory), absoluteLines(memory), directLines(memory), directTargets(memory),
+      recordLines(memory), modificationLines(memory), garbageBytes(0), unsettled(false), registers(memory) {
     registers["A"] = 0;
     registers["X"] = 1;
     registers["L"] = 2;
@@ -20,78 +29,133 @@ Pass2::Pass2(OPTAB *opt, SYMTAB *sym, LITTAB *lit,
 }
 
 int Pass2::getAbsoluteAddress(int blockNum, int offset) const {
-    for (const auto &blockPair : programBlocks) {
-        if (blockPair.second.number == blockNum) {
-            return blockPair.second.startAddress + offset;
+    return programBlocks.absoluteAddress(blockNum, offset);
+}
+
+// value의 하위 count 바이트를 big-endian으로 덧붙인다
+void Pass2::emitBytes(EncodedChunk &out, uint32_t value, int count) const {
+    for (int shift = (count - 1) * 8; shift >= 0; shift -= 8) {
+        out.bytes.push_back(static_cast<uint8_t>(value >> shift));
+    }
+}
+
+// 진단 메시지용 16진수 (std::hex처럼 소문자, 자리 채움 없음)
+static void appendHex(OutputBuffer &out, int value) {
+    char digits[8];
+    auto res = std::to_chars(digits, digits + sizeof(digits), static_cast<uint32_t>(value), 16);
+    out.append(std::string_view(digits, res.ptr - digits));
+}
+
+static int hexDigitValue(char c) {
+    if (c >= '0' && c <= '9')
+        return c - '0';
+    if (c >= 'A' && c <= 'F')
+        return c - 'A' + 10;
+    if (c >= 'a' && c <= 'f')
+        return c - 'a' + 10;
+    return -1;
+}
+
+// X'...' 내용을 바이트로 (홀수 자리면 앞에 0을 붙인 것으로 본다)
+void Pass2::emitHexString(EncodedChunk &out, std::string_view hex) const {
+    size_t pos = 0;
+    int high = 0;
+    if (hex.size() % 2 == 0 && !hex.empty()) {
+        high = hexDigitValue(hex[pos++]);
+    }
+    while (pos < hex.size()) {
+        int low = hexDigitValue(hex[pos++]);
+        if (high < 0 || low < 0) {
+            out.messages.append("Error: Invalid hex constant X'");
+            out.messages.append(hex);
+            out.messages.append("'\n");
+            high = high < 0 ? 0 : high;
+            low = low < 0 ? 0 : low;
+        }
+        out.bytes.push_back(static_cast<uint8_t>((high << 4) | low));
+        if (pos < hex.size()) {
+            high = hexDigitValue(hex[pos++]);
         }
     }
-    return offset;
 }
 
-std::string Pass2::generateObjectCode(IntermediateLine &line, int nextLoc) {
-    if (optab->isInstruction(line.opcode)) {
+void Pass2::generateObjectCode(const IntermediateLine &line, int nextLoc, EncodedChunk &out) const {
+    if (line.kind == LineKind::INSTRUCTION) {
         if (line.isFormat4) {
-            return handleFormat4(line);
+            handleFormat4(line, out);
+            return;
         }
-        int format = optab->getFormat(line.opcode);
+        int format = optab->getFormat(line.opcodeId);
 
         switch (format) {
         case 1:
-            return handleFormat1(line);
+            handleFormat1(line, out);
+            break;
         case 2:
-            return handleFormat2(line);
+            handleFormat2(line, out);
+            break;
         case 3:
-            return handleFormat3(line, nextLoc);
+            handleFormat3(line, nextLoc, out);
+            break;
         default:
-            std::cerr << "Error: Unknown format " << format << " for " << line.opcode << std::endl;
-            return "";
+            out.messages.append("Error: Unknown format ");
+            out.messages.appendDecimalField(format, 0, false, ' ');
+            out.messages.append(" for ");
+            out.messages.append(pool->name(line.opcodeId));
+            out.messages.append('\n');
+            break;
         }
+    } else if (line.kind == LineKind::LITERAL) {
+        handleLiteral(line, out);
     } else {
-        return handleDirective(line);
+        handleDirective(line, out);
     }
 }
 
-std::string Pass2::handleFormat1(const IntermediateLine &line) {
-    return optab->getOpcode(line.opcode);
+void Pass2::handleFormat1(const IntermediateLine &line, EncodedChunk &out) const {
+    emitBytes(out, optab->getOpcode(line.opcodeId), 1);
 }
 
-std::string Pass2::handleFormat2(const IntermediateLine &line) {
-    std::string obj = optab->getOpcode(line.opcode);
-    std::string op = line.operand;
+void Pass2::handleFormat2(const IntermediateLine &line, EncodedChunk &out) const {
+    int opcode_val = optab->getOpcode(line.opcodeId);
+    int r1 = 0, r2 = 0;
+    std::string_view op = line.operand;
 
     size_t comma = op.find(',');
-    if (comma != std::string::npos) {
-        std::string r1_str = Parser::trim(op.substr(0, comma));
-        std::string r2_str = Parser::trim(op.substr(comma + 1));
-
-        int r1 = getRegisterNum(r1_str);
-        int r2 = 0;
-
-        if (line.opcode == "SHIFTL" || line.opcode == "SHIFTR") {
-            r2 = std::stoi(r2_str) - 1;
+    if (comma != std::string_view::npos) {
+        std::string_view r1_str = Parser::trim(op.substr(0, comma));
+        std::string_view r2_str = Parser::trim(op.substr(comma + 1));
+
+        r1 = getRegisterNum(r1_str, out.messages);
+
+        std::string_view mnemonic = pool->name(line.opcodeId);
+        if (mnemonic == "SHIFTL" || mnemonic == "SHIFTR") {
+            if (!Parser::parseNumber(r2_str, 10, r2)) {
+                out.messages.append("Error: Invalid shift count: ");
+                out.messages.append(r2_str);
+                out.messages.append('\n');
+                r2 = 1;
+            }
+            r2 -= 1;
         } else {
-            r2 = getRegisterNum(r2_str);
+            r2 = getRegisterNum(r2_str, out.messages);
         }
-
-        obj += intToHex(r1, 1);
-        obj += intToHex(r2, 1);
     } else {
-        std::string r1_str = Parser::trim(op);
-        int r1 = getRegisterNum(r1_str);
-        obj += intToHex(r1, 1);
-        obj += "0";
+        std::string_view r1_str = Parser::trim(op);
+        r1 = getRegisterNum(r1_str, out.messages);
     }
-    return obj;
+    emitBytes(out, opcode_val, 1);
+    emitBytes(out, ((r1 & 0xF) << 4) | (r2 & 0xF), 1);
 }
 
-std::string Pass2::handleFormat3(const IntermediateLine &line, int nextLoc) {
-    int opcode_val = hexStringToInt(optab->getOpcode(line.opcode));
+void Pass2::handleFormat3(const IntermediateLine &line, int nextLoc, EncodedChunk &out) const {
+    int opcode_val = optab->getOpcode(line.opcodeId);
     int n = 0, i = 0, x = 0, b = 0, p = 0, e = 0;
     int disp = 0;
     int target_addr = 0;
 
-    std::string op = line.operand;
-    std::string clean_op = op;
+    std::string_view op = line.operand;
+    std::string_view clean_op = op;
 
     int currentAbsAddr = getAbsoluteAddress(line.blockNumber, line.location);
     int nextAbsAddr = getAbsoluteAddress(line.blockNumber, nextLoc);
@@ -115,33 +179,38 @@ std::string Pass2::handleFormat3(const IntermediateLine &line, int nextLoc) {
     }
 
     size_t comma_x = clean_op.find(",X");
-    if (comma_x != std::string::npos) {
+    if (comma_x != std::string_view::npos) {
         x = 1;
         clean_op = Parser::trim(clean_op.substr(0, comma_x));
     }
 
-    if (line.opcode != "RSUB") {
+    bool isRSUB = pool->name(line.opcodeId) == "RSUB";
+    SymbolHandle symbol;
+
+    if (!isRSUB) {
         if (!clean_op.empty() && clean_op[0] == '=') {
-            target_addr = littab->getAddress(clean_op);
-        } else if (symtab->exists(clean_op)) {
-            target_addr = symtab->lookup(clean_op);
+            target_addr = literalAddress(line.operandId);
+        } else if ((symbol = symtab->find(line.operandId)) != NO_HANDLE) {
+            target_addr = symbolAddress(symbol);
         } else {
-            try {
-                target_addr = std::stoi(clean_op);
+            if (Parser::parseNumber(clean_op, 10, target_addr)) {
                 if (n == 0 && i == 1) {
                     disp = target_addr & 0xFFF;
                     p = 0;
                     b = 0;
                 }
-            } catch (const std::exception &) {
-                std::cerr << "Error at 0x" << std::hex << currentAbsAddr
-                          << ": Symbol not found: " << clean_op << std::endl;
+            } else {
+                out.messages.append("Error at 0x");
+                appendHex(out.messages, currentAbsAddr);
+                out.messages.append(": Symbol not found: ");
+                out.messages.append(clean_op);
+                out.messages.append('\n');
                 target_addr = 0;
             }
         }
     }
 
-    if (line.opcode == "RSUB") {
+    if (isRSUB) {
         disp = 0;
     } else if (n == 0 && i == 1) {
         if (disp == 0) {
@@ -156,23 +225,25 @@ std::string Pass2::handleFormat3(const IntermediateLine &line, int nextLoc) {
             b = 0;
             disp = disp_pc & 0xFFF;
         } else {
-            if (baseRegister != -1) {
-                int disp_base = target_addr - baseRegister;
+            if (out.baseRegister != -1) {
+                int disp_base = target_addr - out.baseRegister;
 
                 if (disp_base >= 0 && disp_base <= 4095) {
                     p = 0;
                     b = 1;
                     disp = disp_base & 0xFFF;
                 } else {
-                    std::cerr << "Warning: Address 0x" << std::hex << target_addr
-                              << " out of range for both PC and Base relative" << std::dec << std::endl;
+                    out.messages.append("Warning: Address 0x");
+                    appendHex(out.messages, target_addr);
+                    out.messages.append(" out of range for both PC and Base relative\n");
                     p = 0;
                     b = 0;
                     disp = target_addr & 0xFFF;
                 }
             } else {
-                std::cerr << "Warning: PC-relative out of range and BASE not set for address 0x"
-                          << std::hex << target_addr << std::dec << std::endl;
+                out.messages.append("Warning: PC-relative out of range and BASE not set for address 0x");
+                appendHex(out.messages, target_addr);
+                out.messages.append('\n');
                 p = 0;
                 b = 0;
                 disp = target_addr & 0xFFF;
@@ -184,16 +255,16 @@ std::string Pass2::handleFormat3(const IntermediateLine &line, int nextLoc) {
     int flags = (x << 3) + (b << 2) + (p << 1) + e;
     int obj = (first_byte << 16) | (flags << 12) | (disp & 0xFFF);
 
-    return intToHex(obj, 6);
+    emitBytes(out, obj, 3);
 }
 
-std::string Pass2::handleFormat4(const IntermediateLine &line) {
-    int opcode_val = hexStringToInt(optab->getOpcode(line.opcode));
+void Pass2::handleFormat4(const IntermediateLine &line, EncodedChunk &out) const {
+    int opcode_val = optab->getOpcode(line.opcodeId);
     int n = 0, i = 0, x = 0, b = 0, p = 0, e = 1;
     int address = 0;
 
-    std::string op = line.operand;
-    std::string clean_op = op;
+    std::string_view op = line.operand;
+    std::string_view clean_op = op;
 
     if (op.empty()) {
         n = 1;
@@ -213,7 +284,7 @@ std::string Pass2::handleFormat4(const IntermediateLine &line) {
     }
 
     size_t comma_x = clean_op.find(",X");
-    if (comma_x != std::string::npos) {
+    if (comma_x != std::string_view::npos) {
         x = 1;
         clean_op = Parser::trim(clean_op.substr(0, comma_x));
     }
@@ -222,23 +293,21 @@ std::string Pass2::handleFormat4(const IntermediateLine &line) {
     b = 0;
 
     bool needsModification = false;
+    SymbolHandle symbol;
 
     if (!clean_op.empty() && clean_op[0] == '=') {
-        address = littab->getAddress(clean_op);
+        address = literalAddress(line.operandId);
         needsModification = true;
-    } else if (symtab->exists(clean_op)) {
-        address = symtab->lookup(clean_op);
+    } else if ((symbol = symtab->find(line.operandId)) != NO_HANDLE) {
+        address = symbolAddress(symbol);
         needsModification = true;
     } else if (!clean_op.empty()) {
-        try {
-            address = std::stoi(clean_op);
-            if (n == 0 && i == 1) {
-                needsModification = false;
-            } else {
-                needsModification = true;
-            }
-        } catch (const std::exception &) {
-            std::cerr << "Error: Invalid operand for Format 4: " << clean_op << std::endl;
+        if (Parser::parseNumber(clean_op, 10, address)) {
+            needsModification = !(n == 0 && i == 1);
+        } else {
+            out.messages.append("Error: Invalid operand for Format 4: ");
+            out.messages.append(clean_op);
+            out.messages.append('\n');
             address = 0;
         }
     }
@@ -250,296 +319,1158 @@ std::string Pass2::handleFormat4(const IntermediateLine &line) {
     int currentAbsAddr = getAbsoluteAddress(line.blockNumber, line.location);
 
     if (needsModification) {
-        addModificationRecord(currentAbsAddr + 1, 5);
+        out.modifications.push_back(ModificationRecord{currentAbsAddr + 1, 5});
     }
 
-    return intToHex(obj, 8);
+    emitBytes(out, obj, 4);
 }
 
-std::string Pass2::handleDirective(const IntermediateLine &line) {
-    std::string op = line.operand;
+void Pass2::handleDirective(const IntermediateLine &line, EncodedChunk &out) const {
+    std::string_view op = line.operand;
 
-    if (line.opcode == "WORD") {
-        if (symtab->exists(op)) {
-            int val = symtab->lookup(op);
+    switch (line.kind) {
+    case LineKind::WORD: {
+        SymbolHandle symbol = symtab->find(line.operandId);
+        if (symbol != NO_HANDLE) {
+            int val = symbolAddress(symbol);
             int currentAbsAddr = getAbsoluteAddress(line.blockNumber, line.location);
-            addModificationRecord(currentAbsAddr, 6);
-            return intToHex(val, 6);
+            out.modifications.push_back(ModificationRecord{currentAbsAddr, 6});
+            emitBytes(out, val, 3);
         } else {
-            int val = std::stoi(op);
-            return intToHex(val, 6);
+            int val = 0;
+            if (!Parser::parseNumber(op, 10, val)) {
+                out.messages.append("Error: Invalid WORD operand: ");
+                out.messages.append(op);
+                out.messages.append('\n');
+                val = 0;
+            }
+            emitBytes(out, val, 3);
         }
-    } else if (line.opcode == "BYTE") {
+        break;
+    }
+    case LineKind::BYTE:
         if (op.size() >= 3 && op[0] == 'C' && op[1] == '\'') {
-            std::string str_val = op.substr(2, op.length() - 3);
-            std::string obj = "";
-            for (char c : str_val) {
-                obj += intToHex(static_cast<int>(c), 2);
-            }
-            return obj;
+            std::string_view str_val = op.substr(2, op.length() - 3);
+            out.bytes.insert(out.bytes.end(), str_val.begin(), str_val.end());
         } else if (op.size() >= 3 && op[0] == 'X' && op[1] == '\'') {
-            std::string hex_val = op.substr(2, op.length() - 3);
-            return (hex_val.length() % 2 == 0) ? hex_val : "0" + hex_val;
+            emitHexString(out, op.substr(2, op.length() - 3));
         }
-    } else if (line.opcode == "RESW" || line.opcode == "RESB") {
-        return "";
-    } else if (line.opcode == "ORG") {
-        return "";
+        break;
+    default:
+        // RESW/RESB/EQU 등은 오브젝트 코드 없음
+        break;
     }
-    return "";
+}
+
+void Pass2::handleLiteral(const IntermediateLine &line, EncodedChunk &out) const {
+    LiteralHandle literal = littab->find(line.opcodeId);
+    if (literal == NO_LITERAL) {
+        return;
+    }
+    const Literal &lit = littab->at(literal);
+    std::string_view litValue = lit.value;
+    size_t start = out.bytes.size();
+
+    if (litValue.size() >= 3 && litValue[0] == 'C' && litValue[1] == '\'') {
+        std::string_view str_val = litValue.substr(2, litValue.length() - 3);
+        out.bytes.insert(out.bytes.end(), str_val.begin(), str_val.end());
+    } else if (litValue.size() >= 3 && litValue[0] == 'X' && litValue[1] == '\'') {
+        emitHexString(out, litValue.substr(2, litValue.length() - 3));
+    } else {
+        int val = 0;
+        if (!Parser::parseNumber(litValue, 10, val)) {
+            out.messages.append("Error: Invalid literal value ");
+            out.messages.append(litValue);
+            out.messages.append('\n');
+            val = 0;
+        }
+        emitBytes(out, val, 3);
+        return;
+    }
+    // 문자/16진 리터럴은 LITTAB 길이만큼 0으로 채운다
+    while (out.bytes.size() - start < static_cast<size_t>(lit.length)) {
+        out.bytes.push_back(0);
+    }
+}
+
+// 레코드 한 줄씩 (formatObjectProgram과 스트리밍 모드 공용)
+static void appendTextRecord(OutputBuffer &out, int address, const uint8_t *bytes, uint32_t length) {
+    out.append('T');
+    out.appendHexFixed(static_cast<uint32_t>(address), 6);
+    out.appendHexFixed(length, 2);
+    out.appendHexBytes(bytes, length);
+    out.append('\n');
+}
+
+static void appendModificationRecord(OutputBuffer &out, const ModificationRecord &record) {
+    out.append('M');
+    out.appendHexFixed(static_cast<uint32_t>(record.address), 6);
+    out.appendHexFixed(static_cast<uint32_t>(record.length), 2);
+    out.append('\n');
 }
 
 void Pass2::startNewTextRecord(int loc) {
     flushTextRecord();
-    currentTextRecordStartAddr = loc;
-    currentTextRecordLength = 0;
-    currentTextRecord = "T" + intToHex(loc, 6);
+    currentText.address = loc;
+    currentText.offset = static_cast<uint32_t>(objectBytes.size());
+    currentText.length = 0;
 }
 
-void Pass2::appendToTextRecord(const std::string &objCode, int loc) {
-    if (objCode.empty()) {
+void Pass2::appendToTextRecord(const ObjectSpan &code) {
+    if (code.length == 0) {
         flushTextRecord();
         return;
     }
 
-    int codeBytes = objCode.length() / 2;
-
-    if ((currentTextRecordLength + codeBytes > 30) ||
-        (currentTextRecordLength > 0 && loc != currentTextRecordStartAddr + currentTextRecordLength)) {
-        startNewTextRecord(loc);
+    if ((currentText.length + code.length > 30) ||
+        (currentText.length > 0 && code.address != currentText.address + static_cast<int>(currentText.length))) {
+        startNewTextRecord(code.address);
     }
 
-    if (currentTextRecordLength == 0) {
-        currentTextRecordStartAddr = loc;
-        currentTextRecord = "T" + intToHex(loc, 6);
+    if (currentText.length == 0) {
+        currentText.address = code.address;
+        currentText.offset = code.offset;
     }
 
-    currentTextRecord += objCode;
-    currentTextRecordLength += codeBytes;
+    currentText.length += code.length;
 }
 
 void Pass2::flushTextRecord() {
-    if (currentTextRecordLength > 0) {
-        std::string record = currentTextRecord.substr(0, 7) +
-                             intToHex(currentTextRecordLength, 2) +
-                             currentTextRecord.substr(7);
-        textRecords.push_back(record);
+    if (currentText.length > 0) {
+        if (stream) {
+            appendTextRecord(stream->out(), currentText.address, objectBytes.data() + currentText.offset,
+                             currentText.length);
+            stream->flushIfFull();
+        } else {
+            textRecords.push_back(currentText);
+        }
     }
-    currentTextRecord = "";
-    currentTextRecordLength = 0;
-    currentTextRecordStartAddr = 0;
+    currentText = ObjectSpan{0, 0, 0};
 }
 
-void Pass2::addModificationRecord(int address, int length) {
-    std::string mRecord = "M" + intToHex(address, 6) + intToHex(length, 2);
-    modificationRecords.push_back(mRecord);
+// 스트리밍 모드: 이미 쓴 레코드의 바이트를 버리고 아직 열려 있는 T 레코드의 바이트만 남긴다
+void Pass2::compactStreamedBytes() {
+    size_t written = currentText.length > 0 ? currentText.offset : objectBytes.size();
+    objectBytes.erase(objectBytes.begin(), objectBytes.begin() + static_cast<std::ptrdiff_t>(written));
+    if (currentText.length > 0) {
+        currentText.offset = 0;
+    }
 }
 
-bool Pass2::execute() {
-    std::cout << "\n[Step 5] Running Pass 2..." << std::endl;
+// 오브젝트 코드를 만드는 줄인지 (제어 지시어는 텍스트 레코드에도 참여하지 않는다)
+static bool producesCode(LineKind kind) {
+    switch (kind) {
+    case LineKind::START:
+    case LineKind::ORG:
+    case LineKind::LTORG:
+    case LineKind::USE:
+    case LineKind::BASE:
+    case LineKind::NOBASE:
+    case LineKind::END:
+        return false;
+    default:
+        return true;
+    }
+}
+
+// BASE/NOBASE를 적용한 값 (피연산자가 잘못되면 false, base는 그대로)
+bool Pass2::resolveBase(const IntermediateLine &line, int &base) const {
+    if (line.kind == LineKind::NOBASE) {
+        base = -1;
+        return true;
+    }
+    SymbolHandle symbol = symtab->find(line.operandId);
+    if (symbol != NO_HANDLE) {
+        base = symbolAddress(symbol);
+        return true;
+    }
+    int value = 0;
+    if (!Parser::parseNumber(line.operand, 16, value)) {
+        return false;
+    }
+    base = value;
+    return true;
+}
+
+void Pass2::announceBase(const IntermediateLine &line) {
+    if (!resolveBase(line, baseRegister)) {
+        Console::err() << "Error: Invalid BASE operand: " << line.operand << std::endl;
+    } else if (line.kind == LineKind::NOBASE) {
+        Console::verbose() << "Base register unset" << std::endl;
+    } else if (symtab->find(line.operandId) != NO_HANDLE) {
+        Console::verbose() << "Base register set to: 0x" << std::hex << baseRegister << std::dec << std::endl;
+    }
+}
+
+// 모아 둔 진단 메시지를 내보낸다 (BASE/NOBASE 메시지는 그 줄 자리에)
+void Pass2::printMessages(EncodedChunk &chunk) {
+    std::string_view messages = chunk.messages.view();
+    size_t printed = 0;
+    for (const auto &[index, position] : chunk.bases) {
+        Console::err() << messages.substr(printed, position - printed);
+        printed = position;
+        announceBase(intFile.at(index));
+    }
+    Console::err() << messages.substr(printed);
+    chunk.messages.clear();
+    chunk.bases.clear();
+}
+
+// PC 상대 주소의 기준: 같은 블록의 다음 줄 위치 (없으면 명령어 길이만큼 뒤)
+int Pass2::nextLocation(size_t index, const IntermediateLine &line) const {
+    int nextLoc = line.location;
+    if (index + 1 < intFile.size()) {
+        if (intFile.blockNumber(index + 1) == line.blockNumber && intFile.hasLocation(index + 1)) {
+            nextLoc = intFile.location(index + 1);
+        } else {
+            if (line.kind == LineKind::INSTRUCTION) {
+                int format = line.isFormat4 ? 4 : optab->getFormat(line.opcodeId);
+                nextLoc = line.location + format;
+            } else {
+                nextLoc = line.location;
+            }
+        }
+    }
+    return nextLoc;
+}
+
+// 청크의 줄별 결과를 둘 곳을 정한다
+void Pass2::bindChunk(EncodedChunk &chunk) {
+    if (stream) {
+        chunk.localCode.assign(chunk.end - chunk.begin, ObjectSpan{0, 0, 0});
+        chunk.localModifications.assign(chunk.end - chunk.begin, 0);
+        chunk.code = chunk.localCode.data();
+        chunk.modificationLengths = chunk.localModifications.data();
+    } else {
+        chunk.code = lineCode.data() + chunk.begin;
+        chunk.modificationLengths = lineModifications.data() + chunk.begin;
+    }
+}
+
+void Pass2::encodeChunk(EncodedChunk &chunk) {
+    for (size_t i = chunk.begin; i < chunk.end; ++i) {
+        IntermediateLine line = intFile.at(i);
+        if (line.kind == LineKind::BASE || line.kind == LineKind::NOBASE) {
+            resolveBase(line, chunk.baseRegister);
+            chunk.bases.emplace_back(i, chunk.messages.size());
+            continue;
+        }
+        if (!producesCode(line.kind)) {
+            continue;
+        }
+
+        ObjectSpan &code = chunk.code[i - chunk.begin];
+        code.address = getAbsoluteAddress(line.blockNumber, line.location);
+        code.offset = static_cast<uint32_t>(chunk.bytes.size());
+        size_t modifications = chunk.modifications.size();
+        generateObjectCode(line, nextLocation(i, line), chunk);
+        code.length = static_cast<uint32_t>(chunk.bytes.size() - code.offset);
+        chunk.modificationLengths[i - chunk.begin] =
+            chunk.modifications.size() > modifications ? chunk.modifications.back().length : 0;
+    }
+}
+
+// 청크 결과를 줄 순서대로 이어 붙이고 텍스트 레코드를 만든다 (직렬 실행과 같은 결과)
+void Pass2::mergeChunk(EncodedChunk &chunk) {
+    uint32_t base = static_cast<uint32_t>(objectBytes.size());
+    objectBytes.insert(objectBytes.end(), chunk.bytes.begin(), chunk.bytes.end());
+    modificationRecords.insert(modificationRecords.end(), chunk.modifications.begin(), chunk.modifications.end());
+
+    for (size_t i = chunk.begin; i < chunk.end; ++i) {
+        LineKind kind = intFile.kind(i);
+        if (kind == LineKind::USE) {
+            flushTextRecord();
+        } else if (producesCode(kind)) {
+            ObjectSpan &code = chunk.code[i - chunk.begin];
+            code.offset += base;
+            appendToTextRecord(code);
+        }
+    }
+    std::vector<uint8_t>().swap(chunk.bytes);
+    if (stream) {
+        std::vector<ObjectSpan>().swap(chunk.localCode);
+        std::vector<uint8_t>().swap(chunk.localModifications);
+        compactStreamedBytes();
+    }
+}
 
+void Pass2::makeHeaderRecord() {
     std::string progNamePadded = programName;
     progNamePadded.resize(6, ' ');
     headerRecord = "H" + progNamePadded + intToHex(startAddr, 6) + intToHex(programLength, 6);
+}
 
-    for (size_t i = 0; i < intFile.size(); ++i) {
-        IntermediateLine &line = intFile[i];
+void Pass2::makeEndRecord(const IntermediateLine &end) {
+    SymbolHandle symbol = end.operand.empty() ? NO_HANDLE : symtab->find(end.operandId);
+    if (symbol != NO_HANDLE) {
+        firstExecAddr = symbolAddress(symbol);
+    }
+    endRecord = "E" + intToHex(firstExecAddr, 6);
+}
 
-        if (line.opcode == "START" || line.opcode == "ORG" || line.opcode == "LTORG") {
-            continue;
+bool Pass2::execute() {
+    Console::out() << "\n[Step 5] Running Pass 2..." << std::endl;
+
+    makeHeaderRecord();
+    // H 레코드의 값(이름, 시작 주소, 길이)은 Pass 1에서 이미 정해졌으므로 맨 앞 자리에 바로 쓴다
+    if (stream) {
+        stream->out().append(headerRecord);
+        stream->out().append('\n');
+    }
+
+    // 줄별 오브젝트 코드 구간은 리스팅과 증분 갱신용이므로 스트리밍 모드에서는 청크 안에서만 둔다
+    if (!stream) {
+        lineCode.assign(intFile.size(), ObjectSpan{0, 0, 0});
+        lineModifications.assign(intFile.size(), 0);
+    }
+
+    // 1. 사전 훑기: END 위치를 찾고 일정한 줄 수마다 청크를 나눈다 (청크 첫 줄의 BASE 값도 함께)
+    size_t threadCount = workers ? workers->size() : 1;
+    size_t chunkLines = intFile.size() + 1;
+    if (stream) {
+        chunkLines = MIN_CHUNK_LINES; // 한 번에 들고 있는 오브젝트 코드를 청크 몇 개로 제한
+    } else if (threadCount > 1) {
+        chunkLines = std::max(MIN_CHUNK_LINES, intFile.size() / (threadCount * 4));
+    }
+
+    std::deque<EncodedChunk> chunks;
+    int base = baseRegister;
+    auto openChunk = [&](size_t begin) {
+        chunks.emplace_back();
+        EncodedChunk &chunk = chunks.back();
+        chunk.begin = begin;
+        chunk.end = begin;
+        chunk.baseRegister = base;
+    };
+    openChunk(0);
+
+    size_t endLine = intFile.size();
+    for (size_t i = 0; i < intFile.size(); ++i) {
+        LineKind kind = intFile.kind(i);
+        if (kind == LineKind::END) {
+            endLine = i;
+            break;
+        }
+        if (i - chunks.back().begin >= chunkLines) {
+            chunks.back().end = i;
+            openChunk(i);
+        }
+        if (kind == LineKind::BASE || kind == LineKind::NOBASE) {
+            resolveBase(intFile.at(i), base);
+        }
+    }
+    chunks.back().end = endLine;
+
+    // 스트리밍 모드에서는 청크를 몇 개씩 인코딩하고 병합해 인코딩된 바이트가 한꺼번에 쌓이지 않게 한다
+    bool parallel = threadCount > 1 && chunks.size() > 1;
+    size_t window = stream ? threadCount * STREAM_WINDOW_PER_THREAD : chunks.size();
+    for (size_t first = 0; first < chunks.size(); first += window) {
+        size_t count = std::min(window, chunks.size() - first);
+        for (size_t k = first; k < first + count; ++k) {
+            bindChunk(chunks[k]);
         }
 
-        if (line.opcode == "USE") {
-            flushTextRecord();
-            continue;
+        // 2. 청크 인코딩 (공유 테이블은 읽기 전용)
+        if (parallel) {
+            workers->run(count, [&](size_t k) { encodeChunk(chunks[first + k]); });
         }
 
-        if (line.opcode == "BASE") {
-            if (symtab->exists(line.operand)) {
-                baseRegister = symtab->lookup(line.operand);
-                std::cout << "Base register set to: 0x" << std::hex << baseRegister << std::dec << std::endl;
-            } else {
-                try {
-                    baseRegister = std::stoi(line.operand, nullptr, 16);
-                } catch (const std::exception &) {
-                    std::cerr << "Error: Invalid BASE operand: " << line.operand << std::endl;
-                }
+        // 3. 순서대로 병합 (BASE 메시지와 진단 메시지도 줄 순서대로 출력)
+        for (size_t k = first; k < first + count; ++k) {
+            EncodedChunk &chunk = chunks[k];
+            if (!parallel) {
+                encodeChunk(chunk);
             }
-            continue;
+            printMessages(chunk);
+            mergeChunk(chunk);
         }
+    }
+    flushTextRecord();
 
-        if (line.opcode == "NOBASE") {
-            baseRegister = -1;
-            std::cout << "Base register unset" << std::endl;
-            continue;
+    if (endLine < intFile.size()) {
+        makeEndRecord(intFile.at(endLine));
+    }
+
+    Console::out() << "Pass 2 completed successfully" << std::endl;
+    return stream ? finishStream() : true;
+}
+
+bool Pass2::streamTo(const std::string &objFilename) {
+    stream = std::make_unique<BufferedFile>();
+    if (!stream->open(objFilename)) {
+        Console::err() << "Error: Cannot write object file" << std::endl;
+        stream.reset();
+        return false;
+    }
+    streamFilename = objFilename;
+    return true;
+}
+
+// 따로 모아 둔 M 레코드와 E 레코드를 붙이고 닫는다
+bool Pass2::finishStream() {
+    for (const ModificationRecord &record : modificationRecords) {
+        appendModificationRecord(stream->out(), record);
+        stream->flushIfFull();
+    }
+    stream->out().append(endRecord);
+    stream->out().append('\n');
+    if (!stream->close()) {
+        Console::err() << "Error: Cannot write object file" << std::endl;
+        return false;
+    }
+    Console::out() << "\nObject file written: " << streamFilename << std::endl;
+    return true;
+}
+
+// ==================== 증분 갱신 ====================
+// SYMTAB/LITTAB 값에 Pass1이 미뤄 둔 이동을 더한 주소 (일반 실행에서는 이동이 없다)
+int Pass2::symbolAddress(SymbolHandle symbol) const {
+    const SymbolEntry &entry = symtab->at(symbol);
+    return entry.address + intFile.symbolShift(entry.id, entry.blockNumber);
+}
+
+int Pass2::literalAddress(SymbolId literal) const {
+    return littab->getAddress(literal) + intFile.literalShift(literal);
+}
+
+bool Pass2::DirectLine::operator<(const DirectLine &other) const {
+    if (block != other.block) {
+        return block < other.block;
+    }
+    return target != other.target ? target < other.target : line < other.line;
+}
+
+// 피연산자가 리터럴인지 (#, @ 뒤도 본다)
+static bool refersToLiteral(std::string_view operand) {
+    if (!operand.empty() && (operand[0] == '#' || operand[0] == '@')) {
+        operand.remove_prefix(1);
+    }
+    return !operand.empty() && operand[0] == '=';
+}
+
+// PC 상대가 아닌 형식 3 줄인지 (BASE 상대나 직접 주소)
+static bool isFarFormat3(const ObjectSpan &code, const std::pmr::vector<uint8_t> &bytes) {
+    return code.length == 3 && (bytes[code.offset + 1] & 0x20) == 0;
+}
+
+// 정렬된 태그 목록에 넣거나 뺀다
+static void setMember(std::pmr::vector<uint64_t> &list, uint64_t tag, bool member) {
+    auto it = std::lower_bound(list.begin(), list.end(), tag);
+    bool present = it != list.end() && *it == tag;
+    if (member && !present) {
+        list.insert(it, tag);
+    } else if (!member && present) {
+        list.erase(it);
+    }
+}
+
+// 정렬된 태그 목록에서 (low, high) 사이 항목의 범위
+static std::pair<size_t, size_t> tagRange(const std::pmr::vector<uint64_t> &list, uint64_t low, uint64_t high) {
+    size_t first = static_cast<size_t>(std::upper_bound(list.begin(), list.end(), low) - list.begin());
+    size_t last = static_cast<size_t>(std::lower_bound(list.begin() + first, list.end(), high) - list.begin());
+    return {first, last};
+}
+
+// list[first, last)를 values로 바꾼다 (개수가 같으면 덮어쓰기만)
+template <typename List, typename Values>
+static void splice(List &list, size_t first, size_t last, const Values &values) {
+    size_t reused = std::min(last - first, values.size());
+    std::copy_n(values.begin(), reused, list.begin() + first);
+    if (last - first > reused) {
+        list.erase(list.begin() + first + reused, list.begin() + last);
+    } else {
+        list.insert(list.begin() + last, values.begin() + reused, values.end());
+    }
+}
+
+// index 줄에 적용되는 BASE/NOBASE 줄과 그 값 (피연산자가 잘못된 줄은 건너뛴다, 없으면 intFile.size()와 -1)
+size_t Pass2::baseLineAt(size_t index, int &base) const {
+    auto it = std::lower_bound(baseLines.begin(), baseLines.end(), intFile.tag(index));
+    while (it != baseLines.begin()) {
+        --it;
+        size_t line = intFile.indexOf(*it);
+        if (resolveBase(intFile.at(line), base)) {
+            return line;
         }
+    }
+    base = -1;
+    return intFile.size();
+}
 
-        if (line.label == "*") {
-            std::string litValue = littab->getValue(line.opcode);
-            std::string objCode = "";
-            int litLength = littab->getLength(line.opcode);
+// 주소가 움직일 때 이 줄을 어느 색인으로 찾는지 (WATCH_* 비트, 0이면 편집 근처에서만 찾는다)
+uint8_t Pass2::watchFlags(size_t index, const IntermediateLine &line, DirectLine &direct) const {
+    const ObjectSpan &code = lineCode[index];
+    bool literal = refersToLiteral(line.operand);
+    SymbolHandle symbol = literal ? NO_HANDLE : symtab->find(line.operandId);
+    if (line.kind == LineKind::WORD || (line.kind == LineKind::INSTRUCTION && line.isFormat4)) {
+        return symbol != NO_HANDLE || (literal && line.kind != LineKind::WORD) ? WATCH_ABSOLUTE : 0;
+    }
+    if (line.kind != LineKind::INSTRUCTION || optab->getFormat(line.opcodeId) != 3 || code.length != 3 ||
+        pool->name(line.opcodeId) == "RSUB") {
+        return 0;
+    }
+    if (!line.operand.empty() && line.operand[0] == '#') {
+        // 상수 즉시값과 없는 심볼의 즉시값은 위치와 무관
+        return literal || symbol != NO_HANDLE ? WATCH_ABSOLUTE : 0;
+    }
+    // 대상이 줄 위치에 놓이지 않았으면 (숫자, 없는 심볼, EQU) 편집 위치로 찾을 수 없다
+    // (리터럴 주소는 블록 기준이라 0번 블록의 리터럴만 절대 주소와 같이 움직인다)
+    const IntermediateCode::Definition &place = intFile.definition(line.operandId);
+    if ((!literal && symbol == NO_HANDLE) || place.block < 0 || !place.located || (literal && place.block != 0)) {
+        return WATCH_REMOTE;
+    }
 
-            if (litValue.size() >= 3 && litValue[0] == 'C' && litValue[1] == '\'') {
-                std::string str_val = litValue.substr(2, litValue.length() - 3);
-                for (char c : str_val) {
-                    objCode += intToHex(static_cast<int>(c), 2);
-                }
-                while (objCode.length() < litLength * 2) {
-                    objCode += "00";
-                }
-            } else if (litValue.size() >= 3 && litValue[0] == 'X' && litValue[1] == '\'') {
-                std::string hex_val = litValue.substr(2, litValue.length() - 3);
-                objCode = (hex_val.length() % 2 == 0) ? hex_val : "0" + hex_val;
-                while (objCode.length() < litLength * 2) {
-                    objCode += "00";
-                }
-            } else {
-                try {
-                    int val = std::stoi(litValue);
-                    objCode = intToHex(val, 6);
-                } catch (const std::exception &e) {
-                    std::cerr << "Error: Invalid literal value " << litValue << std::endl;
-                    objCode = "000000";
-                }
-            }
+    uint8_t flags = place.block != line.blockNumber ? WATCH_CROSS : 0;
+    int base = -1;
+    size_t baseLine = baseLineAt(index, base);
+    SymbolHandle baseSymbol = NO_HANDLE;
+    if (baseLine < intFile.size() && intFile.kind(baseLine) == LineKind::BASE) {
+        baseSymbol = symtab->find(intFile.at(baseLine).operandId);
+    }
+    if (baseSymbol != NO_HANDLE) {
+        const IntermediateCode::Definition &basePlace = intFile.definition(symtab->at(baseSymbol).id);
+        if (!basePlace.located) {
+            return WATCH_REMOTE;
+        }
+        flags |= basePlace.block != place.block ? WATCH_CROSS : 0;
+    }
+    uint8_t mode = objectBytes[code.offset + 1] & 0x60; // b, p 비트
+    if (mode == 0 || (mode == 0x40 && baseSymbol == NO_HANDLE)) {
+        flags |= WATCH_DIRECT;
+        direct = DirectLine{place.block, place.tag, intFile.tag(index)};
+    }
+    return flags;
+}
 
-            line.objcode = objCode;
-            int absAddr = getAbsoluteAddress(line.blockNumber, line.location);
-            appendToTextRecord(objCode, absAddr);
-            continue;
+// 줄의 directLines 항목을 바꾸거나 뺀다 (direct가 없으면 뺀다)
+void Pass2::watchDirect(uint64_t line, const DirectLine *direct) {
+    auto it = directTargets.find(line);
+    if (it != directTargets.end()) {
+        if (direct && direct->block == it->second.block && direct->target == it->second.target) {
+            return;
         }
+        directLines.erase(std::lower_bound(directLines.begin(), directLines.end(), it->second));
+        directTargets.erase(it);
+    }
+    if (direct) {
+        directLines.insert(std::lower_bound(directLines.begin(), directLines.end(), *direct), *direct);
+        directTargets.emplace(line, *direct);
+    }
+}
 
-        if (line.opcode == "END") {
-            if (!line.operand.empty() && symtab->exists(line.operand)) {
-                firstExecAddr = symtab->lookup(line.operand);
-            }
-            endRecord = "E" + intToHex(firstExecAddr, 6);
+// 인코딩한 줄의 색인과 M 레코드를 고친다
+void Pass2::trackLine(size_t index, const IntermediateLine &line) {
+    uint64_t tag = intFile.tag(index);
+    DirectLine direct{0, 0, tag};
+    uint8_t flags = watchFlags(index, line, direct);
+    setMember(remoteLines, tag, (flags & WATCH_REMOTE) != 0);
+    setMember(crossLines, tag, (flags & WATCH_CROSS) != 0);
+    setMember(absoluteLines, tag, (flags & WATCH_ABSOLUTE) != 0);
+    watchDirect(tag, (flags & WATCH_DIRECT) != 0 ? &direct : nullptr);
+
+    auto it = std::lower_bound(modificationLines.begin(), modificationLines.end(), tag);
+    size_t m = static_cast<size_t>(it - modificationLines.begin());
+    bool present = it != modificationLines.end() && *it == tag;
+    uint8_t length = lineModifications[index];
+    if (length == 0) {
+        if (present) {
+            modificationLines.erase(it);
+            modificationRecords.erase(modificationRecords.begin() + m);
+        }
+        return;
+    }
+    // 형식 4는 주소 필드부터 (5 half-byte), WORD는 줄 시작부터 (6 half-byte)
+    ModificationRecord record{getAbsoluteAddress(line.blockNumber, line.location) + (length == 5 ? 1 : 0), length};
+    if (present) {
+        modificationRecords[m] = record;
+    } else {
+        modificationLines.insert(it, tag);
+        modificationRecords.insert(modificationRecords.begin() + m, record);
+    }
+}
+
+// from부터 다음 BASE/NOBASE 줄 앞까지 BASE 값을 쓸 수 있는 줄 (PC 상대가 아닌 형식 3)
+void Pass2::addGovernedLines(size_t from, std::vector<std::pair<size_t, bool>> &candidates) const {
+    for (size_t i = from; i < intFile.size(); ++i) {
+        LineKind kind = intFile.kind(i);
+        if (kind == LineKind::BASE || kind == LineKind::NOBASE || kind == LineKind::END) {
             break;
         }
+        if (kind == LineKind::INSTRUCTION && isFarFormat3(lineCode[i], objectBytes)) {
+            candidates.emplace_back(i, false);
+        }
+    }
+}
 
-        int nextLoc = line.location;
-        if (i + 1 < intFile.size()) {
-            IntermediateLine &nextLine = intFile[i + 1];
-            if (nextLine.blockNumber == line.blockNumber && nextLine.hasLocation) {
-                nextLoc = nextLine.location;
+// 길이가 같은 줄을 제자리에서 다시 인코딩 (force가 아니면 바이트와 수정 레코드가 그대로일 때 버린다)
+bool Pass2::reencode(size_t index, bool force, EncodedChunk &scratch) {
+    IntermediateLine line = intFile.at(index);
+    if (!producesCode(line.kind)) {
+        return false;
+    }
+    scratch.bytes.clear();
+    scratch.modifications.clear();
+    baseLineAt(index, scratch.baseRegister);
+    generateObjectCode(line, nextLocation(index, line), scratch);
+
+    const ObjectSpan &code = lineCode[index];
+    uint8_t modification = scratch.modifications.empty() ? 0 : scratch.modifications.back().length;
+    size_t length = std::min<size_t>(code.length, scratch.bytes.size());
+    bool changed = force || modification != lineModifications[index] ||
+                   !std::equal(scratch.bytes.begin(), scratch.bytes.begin() + length, objectBytes.begin() + code.offset);
+    if (changed) {
+        printMessages(scratch);
+        std::copy_n(scratch.bytes.begin(), length, objectBytes.begin() + code.offset);
+        lineModifications[index] = modification;
+    } else {
+        scratch.messages.clear();
+    }
+    // BASE 줄이 바뀌었으면 바이트가 같아도 색인이 바뀔 수 있다
+    trackLine(index, line);
+    return changed;
+}
+
+// execute() 뒤 한 번 훑어 색인을 만든다
+void Pass2::prepareUpdates() {
+    if (stream) {
+        return;
+    }
+    references.clear();
+    references.reserve(intFile.size());
+    baseLines.clear();
+    remoteLines.clear();
+    crossLines.clear();
+    absoluteLines.clear();
+    directLines.clear();
+    directTargets.clear();
+    recordLines.clear();
+    modificationLines.clear();
+
+    size_t record = 0;
+    for (size_t i = 0; i < intFile.size(); ++i) {
+        LineKind kind = intFile.kind(i);
+        uint64_t tag = intFile.tag(i);
+        if (kind == LineKind::BASE || kind == LineKind::NOBASE) {
+            baseLines.push_back(tag);
+        }
+        if (!producesCode(kind) && kind != LineKind::BASE) {
+            continue;
+        }
+        IntermediateLine line = intFile.at(i);
+        if (line.operandId != NO_SYMBOL && kind != LineKind::LITERAL) {
+            references.emplace(line.operandId, tag);
+        }
+        if (kind == LineKind::BASE) {
+            continue;
+        }
+        const ObjectSpan &code = lineCode[i];
+        if (record < textRecords.size() && code.length > 0 && code.offset == textRecords[record].offset) {
+            recordLines.push_back(tag);
+            ++record;
+        }
+        if (lineModifications[i] != 0) {
+            modificationLines.push_back(tag);
+        }
+        DirectLine direct{0, 0, tag};
+        uint8_t flags = watchFlags(i, line, direct);
+        if ((flags & WATCH_REMOTE) != 0) {
+            remoteLines.push_back(tag);
+        }
+        if ((flags & WATCH_CROSS) != 0) {
+            crossLines.push_back(tag);
+        }
+        if ((flags & WATCH_ABSOLUTE) != 0) {
+            absoluteLines.push_back(tag);
+        }
+        if ((flags & WATCH_DIRECT) != 0) {
+            directLines.push_back(direct);
+            directTargets.emplace(tag, direct);
+        }
+    }
+    std::sort(directLines.begin(), directLines.end());
+    garbageBytes = 0;
+    unsettled = false;
+    tracking = true;
+}
+
+size_t Pass2::update(const IntermediateEdit &edit, int length) {
+    if (!holdsObjectCode("update the object code")) {
+        return 0;
+    }
+    if (!tracking) {
+        Console::err() << "Error: Cannot update the object code before prepareUpdates()" << std::endl;
+        return 0;
+    }
+    programLength = length;
+    makeHeaderRecord();
+    size_t regionEnd = edit.begin + edit.inserted;
+    uint64_t low = edit.begin > 0 ? intFile.tag(edit.begin - 1) : 0;
+    uint64_t high = intFile.tag(regionEnd); // END 앞까지만 편집하므로 뒤에 항상 줄이 있다
+
+    // 1. 지운 줄을 색인에서 뺀다 (새 줄이 태그를 다시 쓰므로 태그가 (low, high) 사이인 항목)
+    for (const auto &[tag, id] : edit.released) {
+        auto range = references.equal_range(id);
+        for (auto it = range.first; it != range.second; ++it) {
+            if (it->second == tag) {
+                references.erase(it);
+                break;
+            }
+        }
+        watchDirect(tag, nullptr);
+    }
+    for (std::pmr::vector<uint64_t> *list : {&baseLines, &remoteLines, &crossLines, &absoluteLines}) {
+        auto [first, last] = tagRange(*list, low, high);
+        list->erase(list->begin() + first, list->begin() + last);
+    }
+    auto [firstModification, lastModification] = tagRange(modificationLines, low, high);
+    modificationLines.erase(modificationLines.begin() + firstModification,
+                            modificationLines.begin() + lastModification);
+    modificationRecords.erase(modificationRecords.begin() + firstModification,
+                              modificationRecords.begin() + lastModification);
+    splice(lineCode, edit.begin, edit.begin + edit.removed, std::vector<ObjectSpan>(edit.inserted, ObjectSpan{0, 0, 0}));
+    splice(lineModifications, edit.begin, edit.begin + edit.removed, std::vector<uint8_t>(edit.inserted, 0));
+
+    // 2. 범위 밖에서 다시 볼 줄 (줄, 바이트가 같아도 메시지를 다시 낼지)
+    std::vector<std::pair<size_t, bool>> candidates;
+    if (edit.begin > 0) {
+        candidates.emplace_back(edit.begin - 1, false); // 다음 줄 위치가 바뀔 수 있다
+    }
+    for (SymbolId id : edit.redefined) {
+        auto range = references.equal_range(id);
+        for (auto it = range.first; it != range.second; ++it) {
+            size_t i = intFile.indexOf(it->second);
+            if (intFile.kind(i) == LineKind::BASE) {
+                addGovernedLines(i + 1, candidates);
             } else {
-                if (optab->isInstruction(line.opcode)) {
-                    int format = line.isFormat4 ? 4 : optab->getFormat(line.opcode);
-                    nextLoc = line.location + format;
-                } else {
-                    nextLoc = line.location;
+                candidates.emplace_back(i, true);
+            }
+        }
+    }
+    if (edit.baseChanged) {
+        addGovernedLines(regionEnd, candidates);
+    }
+    if (edit.shift != 0) {
+        // 편집 근처: 자신과 대상이 편집을 사이에 두는 줄, 그리고 근처에 정의된 심볼을 BASE 상대/직접 주소로 쓰는 줄
+        // (PC 상대는 2048, BASE 상대는 4096 바이트 안에서만 쓰이므로 둘 다 편집에서 그 거리 안에 있다)
+        int ahead = edit.location + NEAR_WINDOW + std::max(edit.shift, 0);
+        std::vector<SymbolId> nearby;
+        auto visit = [&](size_t i) {
+            IntermediateLine line = intFile.at(i);
+            if (line.kind == LineKind::LITERAL) {
+                nearby.push_back(line.operandId);
+                return;
+            }
+            if (line.labelId != NO_SYMBOL) {
+                nearby.push_back(line.labelId);
+            }
+            if (line.kind != LineKind::INSTRUCTION || line.isFormat4 || line.operandId == NO_SYMBOL) {
+                return;
+            }
+            const IntermediateCode::Definition &place = intFile.definition(line.operandId);
+            if (place.block == edit.block && place.located && (intFile.tag(i) >= high) != (place.tag >= high)) {
+                candidates.emplace_back(i, false);
+            }
+        };
+        for (size_t i = edit.begin; i-- > 0;) {
+            if (intFile.blockNumber(i) != edit.block || !intFile.hasLocation(i)) {
+                continue;
+            }
+            if (intFile.location(i) < edit.location - NEAR_WINDOW) {
+                break;
+            }
+            visit(i);
+        }
+        for (size_t i = regionEnd; i < intFile.size(); ++i) {
+            if (intFile.blockNumber(i) != edit.block || !intFile.hasLocation(i)) {
+                continue;
+            }
+            if (intFile.location(i) > ahead) {
+                break;
+            }
+            visit(i);
+        }
+        for (SymbolId id : nearby) {
+            auto range = references.equal_range(id);
+            for (auto it = range.first; it != range.second; ++it) {
+                size_t i = intFile.indexOf(it->second);
+                if (intFile.kind(i) == LineKind::INSTRUCTION && isFarFormat3(lineCode[i], objectBytes)) {
+                    candidates.emplace_back(i, false);
                 }
             }
         }
 
-        std::string objCode = generateObjectCode(line, nextLoc);
+        // 직접 주소로 움직인 대상을 쓰는 줄: (블록, 태그) 순서로 편집 지점 뒤쪽
+        auto moved = std::lower_bound(directLines.begin(), directLines.end(), DirectLine{edit.block, high, 0});
+        for (; moved != directLines.end(); ++moved) {
+            candidates.emplace_back(intFile.indexOf(moved->line), false);
+        }
+        for (uint64_t tag : remoteLines) {
+            candidates.emplace_back(intFile.indexOf(tag), false);
+        }
+        // 다른 블록의 줄과 가까운 것은 편집이 블록 시작이나 끝 근처일 때뿐이다
+        if (edit.location < NEAR_WINDOW || programBlocks[edit.block].length <= ahead) {
+            for (uint64_t tag : crossLines) {
+                candidates.emplace_back(intFile.indexOf(tag), false);
+            }
+        }
+    }
+    // 같은 줄은 하나만 (force인 항목이 앞에 오게 정렬)
+    std::sort(candidates.begin(), candidates.end(), [](const auto &a, const auto &b) {
+        return a.first != b.first ? a.first < b.first : a.second > b.second;
+    });
+    candidates.erase(std::unique(candidates.begin(), candidates.end(),
+                                 [](const auto &a, const auto &b) { return a.first == b.first; }),
+                     candidates.end());
+
+    // 3. 메시지가 줄 순서대로 나오도록 범위 앞 후보, 새 줄, 범위 뒤 후보 순서로 인코딩
+    EncodedChunk scratch;
+    size_t encoded = 0;
+    auto next = candidates.begin();
+    for (; next != candidates.end() && next->first < edit.begin; ++next) {
+        encoded += reencode(next->first, next->second, scratch) ? 1 : 0;
+    }
+
+    EncodedChunk region;
+    int base = -1;
+    if (edit.inserted > 0) {
+        baseLineAt(edit.begin, base);
+    }
+    for (size_t i = edit.begin; i < regionEnd; ++i) {
+        IntermediateLine line = intFile.at(i);
+        if (line.operandId != NO_SYMBOL) {
+            references.emplace(line.operandId, intFile.tag(i));
+        }
+        if (line.kind == LineKind::BASE || line.kind == LineKind::NOBASE) {
+            resolveBase(line, base);
+            region.bases.emplace_back(i, region.messages.size());
+            setMember(baseLines, intFile.tag(i), true);
+            continue;
+        }
+        if (!producesCode(line.kind)) {
+            continue;
+        }
+        ObjectSpan &code = lineCode[i];
+        code.address = getAbsoluteAddress(line.blockNumber, line.location);
+        code.offset = static_cast<uint32_t>(region.bytes.size());
+        region.baseRegister = base;
+        size_t modifications = region.modifications.size();
+        generateObjectCode(line, nextLocation(i, line), region);
+        code.length = static_cast<uint32_t>(region.bytes.size() - code.offset);
+        lineModifications[i] = region.modifications.size() > modifications ? region.modifications.back().length : 0;
+        ++encoded;
+    }
+    printMessages(region);
+    // 새 줄의 바이트는 잠시 끝에 두었다가 레코드를 고칠 때 레코드 자리로 옮긴다
+    uint32_t offset = static_cast<uint32_t>(objectBytes.size());
+    objectBytes.insert(objectBytes.end(), region.bytes.begin(), region.bytes.end());
+    garbageBytes += region.bytes.size();
+    for (size_t i = edit.begin; i < regionEnd; ++i) {
+        IntermediateLine line = intFile.at(i);
+        if (producesCode(line.kind)) {
+            lineCode[i].offset += offset;
+            trackLine(i, line);
+        }
+    }
+
+    for (; next != candidates.end(); ++next) {
+        if (next->first >= regionEnd) {
+            encoded += reencode(next->first, next->second, scratch) ? 1 : 0;
+        }
+    }
 
-        line.objcode = objCode;
+    // 4. 레코드: 바뀐 T 레코드만 다시 나누고, E 레코드는 새 주소로
+    patchTextRecords(edit.begin, regionEnd);
+    if (intFile.kind(intFile.size() - 1) == LineKind::END) {
+        makeEndRecord(intFile.at(intFile.size() - 1));
+    }
+    unsettled = unsettled || edit.shift != 0;
+    if (garbageBytes > objectBytes.size() / 2) {
+        compactObjectBytes();
+    }
+    return encoded;
+}
 
-        int absAddr = getAbsoluteAddress(line.blockNumber, line.location);
-        appendToTextRecord(objCode, absAddr);
+// 범위 앞의 마지막 레코드부터 execute와 같은 규칙으로 다시 나누다가, 범위 뒤에서 이전 레코드와
+// 같은 줄에서 새 레코드를 시작하게 되면 멈춘다 (그 뒤 레코드는 줄 구성이 같고 바이트도 제자리에 있다)
+void Pass2::patchTextRecords(size_t begin, size_t regionEnd) {
+    size_t first = static_cast<size_t>(
+        std::lower_bound(recordLines.begin(), recordLines.end(), intFile.tag(begin)) - recordLines.begin());
+    size_t scan = begin;
+    if (first > 0) {
+        --first;
+        scan = intFile.indexOf(recordLines[first]);
     }
 
-    flushTextRecord();
+    std::vector<ObjectSpan> records;
+    std::vector<uint64_t> firsts;
+    std::vector<uint8_t> bytes;
+    std::vector<std::pair<size_t, uint32_t>> moved; // 줄, bytes 안 위치
+    ObjectSpan current{0, 0, 0};
+    auto close = [&]() {
+        if (current.length > 0) {
+            records.push_back(current);
+        }
+        current = ObjectSpan{0, 0, 0};
+    };
+    size_t old = first;
+    size_t last = recordLines.size();
+    for (size_t i = scan; i < intFile.size(); ++i) {
+        LineKind kind = intFile.kind(i);
+        if (kind == LineKind::END) {
+            break;
+        }
+        if (kind == LineKind::USE) {
+            close();
+            continue;
+        }
+        const ObjectSpan &code = lineCode[i];
+        if (!producesCode(kind)) {
+            continue;
+        }
+        if (code.length == 0) {
+            close();
+            continue;
+        }
+        int address = getAbsoluteAddress(intFile.blockNumber(i), intFile.location(i));
+        if (current.length > 0 &&
+            (current.length + code.length > 30 || address != current.address + static_cast<int>(current.length))) {
+            close();
+        }
+        if (current.length == 0) {
+            uint64_t tag = intFile.tag(i);
+            if (i >= regionEnd) {
+                while (old < recordLines.size() && recordLines[old] < tag) {
+                    ++old;
+                }
+                if (old < recordLines.size() && recordLines[old] == tag) {
+                    last = old;
+                    break;
+                }
+            }
+            current.address = address;
+            current.offset = static_cast<uint32_t>(bytes.size());
+            firsts.push_back(tag);
+        }
+        moved.emplace_back(i, static_cast<uint32_t>(bytes.size()));
+        bytes.insert(bytes.end(), objectBytes.begin() + code.offset, objectBytes.begin() + code.offset + code.length);
+        current.length += code.length;
+    }
+    close();
 
-    std::cout << "Pass 2 completed successfully" << std::endl;
-    return true;
+    // 새 레코드의 바이트를 끝에 붙이고 옛 레코드 자리는 버린다
+    uint32_t offset = static_cast<uint32_t>(objectBytes.size());
+    objectBytes.insert(objectBytes.end(), bytes.begin(), bytes.end());
+    for (const auto &[line, position] : moved) {
+        lineCode[line].offset = offset + position;
+    }
+    for (ObjectSpan &record : records) {
+        record.offset += offset;
+    }
+    for (size_t r = first; r < last; ++r) {
+        garbageBytes += textRecords[r].length;
+    }
+    splice(textRecords, first, last, records);
+    splice(recordLines, first, last, firsts);
 }
 
-void Pass2::writeObjFile(const std::string &objFilename) const {
-    std::ofstream file(objFilename);
-    if (!file.is_open()) {
-        std::cerr << "Error: Cannot write object file" << std::endl;
+// 버린 바이트가 쓰는 바이트보다 많아지면 레코드 순서대로 다시 모은다
+void Pass2::compactObjectBytes() {
+    std::pmr::vector<uint8_t> compact(objectBytes.get_allocator());
+    compact.reserve(objectBytes.size() - garbageBytes);
+    size_t record = 0;
+    for (size_t i = 0; i < intFile.size(); ++i) {
+        ObjectSpan &code = lineCode[i];
+        if (code.length == 0 || !producesCode(intFile.kind(i))) {
+            continue;
+        }
+        uint32_t offset = static_cast<uint32_t>(compact.size());
+        if (record < recordLines.size() && recordLines[record] == intFile.tag(i)) {
+            textRecords[record++].offset = offset;
+        }
+        compact.insert(compact.end(), objectBytes.begin() + code.offset, objectBytes.begin() + code.offset + code.length);
+        code.offset = offset;
+    }
+    objectBytes.swap(compact);
+    garbageBytes = 0;
+}
+
+// 편집마다 미뤄 둔 T/M 레코드 주소와 절대 주소 필드(형식 4, WORD, #심볼)를 고친다
+void Pass2::settle() {
+    if (!tracking || !unsettled) {
         return;
     }
+    EncodedChunk scratch;
+    scratch.baseRegister = -1; // 절대 주소 필드는 BASE와 무관
+    for (uint64_t tag : absoluteLines) {
+        size_t index = intFile.indexOf(tag);
+        IntermediateLine line = intFile.at(index);
+        scratch.bytes.clear();
+        generateObjectCode(line, nextLocation(index, line), scratch);
+        const ObjectSpan &code = lineCode[index];
+        std::copy_n(scratch.bytes.begin(), std::min<size_t>(code.length, scratch.bytes.size()),
+                    objectBytes.begin() + code.offset);
+    }
+    for (size_t r = 0; r < textRecords.size(); ++r) {
+        size_t index = intFile.indexOf(recordLines[r]);
+        textRecords[r].address = getAbsoluteAddress(intFile.blockNumber(index), intFile.location(index));
+    }
+    for (size_t m = 0; m < modificationRecords.size(); ++m) {
+        size_t index = intFile.indexOf(modificationLines[m]);
+        int address = getAbsoluteAddress(intFile.blockNumber(index), intFile.location(index));
+        modificationRecords[m].address = address + (modificationRecords[m].length == 5 ? 1 : 0);
+    }
+    unsettled = false;
+}
 
-    file << headerRecord << std::endl;
-    for (const auto &tRec : textRecords) {
-        file << tRec << std::endl;
+// 스트리밍 모드에서는 T 레코드와 줄별 오브젝트 코드가 이미 파일로 나가고 남아 있지 않다
+bool Pass2::holdsObjectCode(const char *operation) const {
+    if (streamFilename.empty()) {
+        return true;
     }
-    for (const auto &mRec : modificationRecords) {
-        file << mRec << std::endl;
+    Console::err() << "Error: Cannot " << operation << ": object code was streamed to " << streamFilename
+                   << std::endl;
+    return false;
+}
+
+bool Pass2::writeObjFile(const std::string &objFilename) const {
+    OutputBuffer out;
+    if (!formatObjectProgram(out)) {
+        return false;
+    }
+    if (!out.writeTo(objFilename)) {
+        Console::err() << "Error: Cannot write object file" << std::endl;
+        return false;
     }
-    file << endRecord << std::endl;
+    Console::out() << "\nObject file written: " << objFilename << std::endl;
+    return true;
+}
 
-    file.close();
-    std::cout << "\nObject file written: " << objFilename << std::endl;
+bool Pass2::printObjFile() const {
+    if (!holdsObjectCode("print the object program")) {
+        return false;
+    }
+    Console::out() << "\n"
+                   << std::string(80, '=') << std::endl;
+    Console::out() << "OBJECT PROGRAM (OBJFILE)" << std::endl;
+    Console::out() << std::string(80, '=') << std::endl;
+    OutputBuffer out;
+    formatObjectProgram(out);
+    Console::out() << out.view();
+    Console::out() << std::string(80, '=') << std::endl;
+    return true;
 }
 
-void Pass2::printObjFile() const {
-    std::cout << "\n"
-              << std::string(80, '=') << std::endl;
-    std::cout << "OBJECT PROGRAM (OBJFILE)" << std::endl;
-    std::cout << std::string(80, '=') << std::endl;
-    std::cout << headerRecord << std::endl;
-    for (const auto &tRec : textRecords) {
-        std::cout << tRec << std::endl;
+bool Pass2::printListingFile() const {
+    if (!holdsObjectCode("print the listing")) {
+        return false;
     }
-    for (const auto &mRec : modificationRecords) {
-        std::cout << mRec << std::endl;
-    }
-    std::cout << endRecord << std::endl;
-    std::cout << std::string(80, '=') << std::endl;
-}
-
-void Pass2::printListingFile() const {
-    std::cout << "\n"
-              << std::string(80, '=') << std::endl;
-    std::cout << "PROGRAM LISTING (with Object Code)" << std::endl;
-    std::cout << std::string(80, '=') << std::endl;
-    std::cout << std::left
-              << std::setw(10) << "LOC"
-              << std::setw(10) << "LABEL"
-              << std::setw(10) << "OPCODE"
-              << std::setw(20) << "OPERAND"
-              << "OBJCODE" << std::endl;
-    std::cout << std::string(80, '-') << std::endl;
-
-    for (const auto &line : intFile) {
-        if (line.opcode == "START" || line.opcode == "END") {
-            std::cout << "          "
-                      << std::left << std::setfill(' ')
-                      << std::setw(10) << line.label
-                      << std::setw(10) << line.opcode
-                      << std::setw(20) << line.operand << std::endl;
+    Console::out() << "\n"
+                   << std::string(80, '=') << std::endl;
+    Console::out() << "PROGRAM LISTING (with Object Code)" << std::endl;
+    Console::out() << std::string(80, '=') << std::endl;
+    Console::out() << std::left
+                   << std::setw(10) << "LOC"
+                   << std::setw(10) << "LABEL"
+                   << std::setw(10) << "OPCODE"
+                   << std::setw(20) << "OPERAND"
+                   << "OBJCODE" << std::endl;
+    Console::out() << std::string(80, '-') << std::endl;
+
+    for (size_t i = 0; i < intFile.size(); ++i) {
+        IntermediateLine line = intFile.at(i);
+        std::string_view opcode = pool->name(line.opcodeId);
+        if (line.kind == LineKind::START || line.kind == LineKind::END) {
+            Console::out() << "          "
+                           << std::left << std::setfill(' ')
+                           << std::setw(10) << pool->name(line.labelId)
+                           << std::setw(10) << opcode
+                           << std::setw(20) << line.operand << std::endl;
             continue;
         }
 
         if (line.hasLocation) {
             // 절대 주소 계산 (블록 시작 주소 + 상대 주소)
             int absAddr = getAbsoluteAddress(line.blockNumber, line.location);
-            std::cout << "0x" << std::hex << std::uppercase
-                      << std::setw(4) << std::setfill('0') << absAddr << "  ";
+            Console::out() << "0x" << std::hex << std::uppercase
+                           << std::setw(4) << std::setfill('0') << absAddr << "  ";
         } else {
-            std::cout << "          ";
+            Console::out() << "          ";
         }
 
-        std::cout << std::dec << std::left << std::setfill(' ')
-                  << std::setw(10) << line.label
-                  << std::setw(10) << line.opcode
-                  << std::setw(20) << line.operand
-                  << line.objcode << std::endl;
+        Console::out() << std::dec << std::left << std::setfill(' ')
+                       << std::setw(10) << pool->name(line.labelId)
+                       << std::setw(10) << opcode
+                       << std::setw(20) << line.operand
+                       << bytesToHex(lineCode[i]) << std::endl;
     }
-    std::cout << std::string(80, '=') << std::endl;
+    Console::out() << std::string(80, '=') << std::endl;
+    return true;
 }
 
 std::string Pass2::intToHex(int val, int width) const {
-    std::stringstream ss;
-    unsigned long long mask = (1ULL << (width * 4)) - 1;
-    ss << std::hex << std::uppercase << std::setfill('0') << std::setw(width)
-       << (static_cast<unsigned long long>(val) & mask);
-    return ss.str();
+    OutputBuffer out(width);
+    out.appendHexFixed(static_cast<uint32_t>(val), width);
+    return std::string(out.view());
+}
+
+std::string Pass2::bytesToHex(const ObjectSpan &code) const {
+    OutputBuffer out(code.length * 2);
+    out.appendHexBytes(objectBytes.data() + code.offset, code.length);
+    return std::string(out.view());
+}
+
+// 레코드를 텍스트로 만들지 않고 그대로 넘긴다 (라이브러리 API)
+bool Pass2::exportProgram(ObjectProgram &program) const {
+    if (!holdsObjectCode("export the object program")) {
+        return false;
+    }
+    program.name = programName;
+    program.startAddress = startAddr;
+    program.length = programLength;
+    program.textRecords.clear();
+    program.textRecords.reserve(textRecords.size());
+    for (const ObjectSpan &record : textRecords) {
+        const uint8_t *bytes = objectBytes.data() + record.offset;
+        program.textRecords.push_back(TextRecord{record.address, std::vector<uint8_t>(bytes, bytes + record.length)});
+    }
+    program.modificationRecords.assign(modificationRecords.begin(), modificationRecords.end());
+    program.firstExecAddress = firstExecAddr;
+    return true;
 }
 
-int Pass2::hexStringToInt(const std::string &hexStr) const {
-    return std::stoi(hexStr, nullptr, 16);
+// H, T..., M..., E 레코드를 한 버퍼에 모은다 (파일/콘솔 출력 공용)
+bool Pass2::formatObjectProgram(OutputBuffer &out) const {
+    if (!holdsObjectCode("format the object program")) {
+        return false;
+    }
+    size_t textBytes = 0;
+    for (const auto &tRec : textRecords) {
+        textBytes += tRec.length;
+    }
+    size_t capacity = headerRecord.size() + endRecord.size() + 2 + textRecords.size() * 10 + textBytes * 2 +
+                      modificationRecords.size() * 10;
+    out.reserve(out.size() + capacity);
+
+    out.append(headerRecord);
+    out.append('\n');
+    for (const auto &tRec : textRecords) {
+        appendTextRecord(out, tRec.address, objectBytes.data() + tRec.offset, tRec.length);
+    }
+    for (const auto &mRec : modificationRecords) {
+        appendModificationRecord(out, mRec);
+    }
+    out.append(endRecord);
+    out.append('\n');
+    return true;
 }
 
-int Pass2::getRegisterNum(const std::string &reg) const {
+int Pass2::getRegisterNum(std::string_view reg, OutputBuffer &messages) const {
     auto it = registers.find(reg);
     if (it != registers.end()) {
         return it->second;
     }
-    std::cerr << "Warning: Unknown register " << reg << std::endl;
+    messages.append("Warning: Unknown register ");
+    messages.append(reg);
+    messages.append('\n');
     return 0;
 }
\ No newline at end of file
@@ -1,121 +1,236 @@
 #include "../include/assembler.h"
 #include <sstream> // stringstream을 사용하기 위해 추가
 
-SYMTAB::SYMTAB() : programBlocks(nullptr) {}
+SYMTAB::SYMTAB(SymbolPool *symbolPool, std::pmr::memory_resource *memory)
+    : pool(symbolPool), entries(memory), slots(memory), blocks(nullptr), mask(0) {}
 
-bool SYMTAB::insert(const std::string &symbol, int address, int blockNum) {
+// SymbolId는 이미 정수이므로 곱셈 해시로 섞기만 한다
+size_t SYMTAB::slotOf(SymbolId symbol) const {
+    return (static_cast<uint32_t>(symbol) * 2654435769u) & mask;
+}
+
+void SYMTAB::rehash(size_t capacity) {
+    slots.assign(capacity, Slot{NO_SYMBOL, 0});
+    mask = capacity - 1;
+    for (size_t handle = 0; handle < entries.size(); ++handle) {
+        size_t slot = slotOf(entries[handle].id);
+        while (slots[slot].id != NO_SYMBOL) {
+            slot = (slot + 1) & mask;
+        }
+        slots[slot] = Slot{entries[handle].id, static_cast<uint32_t>(handle)};
+    }
+}
+
+SymbolHandle SYMTAB::find(SymbolId symbol) const {
+    if (slots.empty() || symbol == NO_SYMBOL) {
+        return NO_HANDLE;
+    }
+    for (size_t slot = slotOf(symbol);; slot = (slot + 1) & mask) {
+        const Slot &s = slots[slot];
+        if (s.id == symbol) {
+            return static_cast<SymbolHandle>(s.entry);
+        }
+        if (s.id == NO_SYMBOL) {
+            return NO_HANDLE;
+        }
+    }
+}
+
+const SymbolEntry &SYMTAB::at(SymbolHandle handle) const {
+    return entries[handle];
+}
+
+size_t SYMTAB::size() const {
+    return entries.size();
+}
+
+bool SYMTAB::insert(SymbolId symbol, int address, int blockNum) {
     if (exists(symbol)) {
-        std::cerr << "Error: Duplicate symbol '" << symbol << "'" << std::endl;
+        Console::err() << "Error: Duplicate symbol '" << pool->name(symbol) << "'" << std::endl;
         return false;
     }
-    table[symbol] = std::make_pair(address, blockNum);
+    // 적재율 1/2 이하 유지
+    if ((entries.size() + 1) * 2 > slots.size()) {
+        entries.push_back(SymbolEntry{symbol, address, blockNum});
+        rehash(std::max<size_t>(16, slots.size() * 2));
+        return true;
+    }
+    size_t slot = slotOf(symbol);
+    while (slots[slot].id != NO_SYMBOL) {
+        slot = (slot + 1) & mask;
+    }
+    slots[slot] = Slot{symbol, static_cast<uint32_t>(entries.size())};
+    entries.push_back(SymbolEntry{symbol, address, blockNum});
     return true;
 }
 
-void SYMTAB::setProgramBlocks(const std::map<std::string, ProgramBlock> *blocks) {
-    programBlocks = blocks;
+bool SYMTAB::erase(SymbolId symbol) {
+    SymbolHandle handle = find(symbol);
+    if (handle == NO_HANDLE) {
+        return false;
+    }
+    size_t hole = slotOf(symbol);
+    while (slots[hole].id != symbol) {
+        hole = (hole + 1) & mask;
+    }
+    // 선형 탐사 삭제: 뒤따르는 슬롯 중 원래 자리가 빈칸 앞인 것을 당겨 온다
+    for (size_t next = (hole + 1) & mask; slots[next].id != NO_SYMBOL; next = (next + 1) & mask) {
+        size_t home = slotOf(slots[next].id);
+        if (((next - home) & mask) >= ((next - hole) & mask)) {
+            slots[hole] = slots[next];
+            hole = next;
+        }
+    }
+    slots[hole] = Slot{NO_SYMBOL, 0};
+
+    uint32_t last = static_cast<uint32_t>(entries.size() - 1);
+    if (static_cast<uint32_t>(handle) != last) {
+        entries[handle] = entries[last];
+        size_t slot = slotOf(entries[handle].id);
+        while (slots[slot].id != entries[handle].id) {
+            slot = (slot + 1) & mask;
+        }
+        slots[slot].entry = static_cast<uint32_t>(handle);
+    }
+    entries.pop_back();
+    return true;
 }
 
-int SYMTAB::lookup(const std::string &symbol) const {
-    auto it = table.find(symbol);
-    if (it != table.end()) {
-        return it->second.first; // address
-    }
-    return -1;
+void SYMTAB::setProgramBlocks(const BlockTable *programBlocks) {
+    blocks = programBlocks;
 }
 
-int SYMTAB::getBlockNumber(const std::string &symbol) const {
-    auto it = table.find(symbol);
-    if (it != table.end()) {
-        return it->second.second; // blockNum
-    }
-    return -1;
+int SYMTAB::lookup(SymbolId symbol) const {
+    SymbolHandle handle = find(symbol);
+    return handle != NO_HANDLE ? entries[handle].address : -1;
+}
+
+int SYMTAB::getBlockNumber(SymbolId symbol) const {
+    SymbolHandle handle = find(symbol);
+    return handle != NO_HANDLE ? entries[handle].blockNumber : -1;
+}
+
+bool SYMTAB::exists(SymbolId symbol) const {
+    return find(symbol) != NO_HANDLE;
+}
+
+bool SYMTAB::exists(std::string_view symbol) const {
+    return exists(pool->find(symbol));
+}
+
+int SYMTAB::lookup(std::string_view symbol) const {
+    return lookup(pool->find(symbol));
 }
 
-bool SYMTAB::exists(const std::string &symbol) const {
-    return table.find(symbol) != table.end();
+SymbolPool *SYMTAB::getPool() const {
+    return pool;
 }
 
-std::vector<std::string> SYMTAB::getAllSymbols() const {
-    std::vector<std::string> symbols;
-    for (const auto &entry : table) {
-        symbols.push_back(entry.first);
+std::vector<SymbolId> SYMTAB::getAllSymbols() const {
+    std::vector<SymbolId> symbols;
+    symbols.reserve(entries.size());
+    for (const SymbolEntry &entry : entries) {
+        symbols.push_back(entry.id);
     }
     return symbols;
 }
 
-void SYMTAB::updateAddress(const std::string &symbol, int newAddress) {
-    auto it = table.find(symbol);
-    if (it != table.end()) {
-        it->second.first = newAddress; // address 업데이트
+// 출력용: 이름 순으로 정렬한 핸들 목록 (print/writeToFile에서만 사용)
+std::vector<SymbolHandle> SYMTAB::sortedSnapshot() const {
+    std::vector<SymbolHandle> handles(entries.size());
+    for (size_t i = 0; i < handles.size(); ++i) {
+        handles[i] = static_cast<SymbolHandle>(i);
+    }
+    std::sort(handles.begin(), handles.end(), [this](SymbolHandle a, SymbolHandle b) {
+        return pool->name(entries[a].id) < pool->name(entries[b].id);
+    });
+    return handles;
+}
+
+void SYMTAB::updateAddress(SymbolId symbol, int newAddress) {
+    SymbolHandle handle = find(symbol);
+    if (handle != NO_HANDLE) {
+        entries[handle].address = newAddress; // address 업데이트
     }
 }
 
+void SYMTAB::updateAddress(SymbolHandle handle, int newAddress) {
+    entries[handle].address = newAddress;
+}
+
 void SYMTAB::print() const {
-    std::cout << "\n"
-              << std::string(60, '=') << std::endl;
-    std::cout << "SYMBOL TABLE (SYMTAB)" << std::endl;
-    std::cout << std::string(60, '=') << std::endl;
-    std::cout << std::left << std::setw(20) << "Symbol"
-              << std::setw(15) << "Address"
-              << std::setw(10) << "Block" << std::endl; // 헤더 너비
-    std::cout << std::string(60, '-') << std::endl;
+    Console::out() << "\n"
+                   << std::string(60, '=') << std::endl;
+    Console::out() << "SYMBOL TABLE (SYMTAB)" << std::endl;
+    Console::out() << std::string(60, '=') << std::endl;
+    Console::out() << std::left << std::setw(20) << "Symbol"
+                   << std::setw(15) << "Address"
+                   << std::setw(10) << "Block" << std::endl; // 헤더 너비
+    Console::out() << std::string(60, '-') << std::endl;
 
     // ▼▼▼ 수정된 출력 루프 ▼▼▼
-    for (const auto &entry : table) {
+    for (SymbolHandle handle : sortedSnapshot()) {
+        const SymbolEntry &entry = entries[handle];
         // 1. Symbol (width 20)
-        std::cout << std::left << std::setw(20) << entry.first;
+        Console::out() << std::left << std::setw(20) << pool->name(entry.id);
 
         // 2. Address (width 15)
         // stringstream을 사용해 주소 문자열("0xXXXX")을 먼저 만듭니다.
         std::stringstream ss;
         ss << "0x" << std::hex << std::uppercase
-           << std::setfill('0') << std::setw(4) << entry.second.first;
+           << std::setfill('0') << std::setw(4) << entry.address;
 
         // 주소 문자열을 왼쪽 정렬, 공백 채우기, 너비 15로 출력합니다.
-        std::cout << std::left << std::setfill(' ') << std::setw(15) << ss.str();
+        Console::out() << std::left << std::setfill(' ') << std::setw(15) << ss.str();
 
         // 3. Block (width 10)
         // 10칸 너비로 블록 번호 출력
-        std::cout << std::left << std::dec << std::setw(10) << entry.second.second << std::endl;
+        Console::out() << std::left << std::dec << std::setw(10) << entry.blockNumber << std::endl;
     }
     // ▲▲▲ 수정된 출력 루프 ▲▲▲
 
-    std::cout << std::string(60, '=') << std::endl;
+    Console::out() << std::string(60, '=') << std::endl;
 }
 
-void SYMTAB::writeToFile(const std::string &filename) const {
-    std::ofstream file(filename);
-    if (!file.is_open()) {
-        std::cerr << "Error: Cannot write SYMTAB file" << std::endl;
-        return;
-    }
-
-    file << std::string(60, '=') << std::endl;
-    file << "SYMBOL TABLE (SYMTAB)" << std::endl;
-    file << std::string(60, '=') << std::endl;
-    file << std::left << std::setw(20) << "Symbol"
-         << std::setw(15) << "Address"
-         << std::setw(10) << "Block" << std::endl; // 헤더 너비
-    file << std::string(60, '-') << std::endl;
-
-    // ▼▼▼ 수정된 파일 쓰기 루프 ▼▼▼
-    for (const auto &entry : table) {
+void SYMTAB::format(OutputBuffer &out) const {
+    out.reserve(out.size() + 256 + entries.size() * 48);
+    out.appendRepeat('=', 60);
+    out.append("\nSYMBOL TABLE (SYMTAB)\n");
+    out.appendRepeat('=', 60);
+    out.append('\n');
+    out.appendPadded("Symbol", 20);
+    out.appendPadded("Address", 15);
+    out.appendPadded("Block", 10); // 헤더 너비
+    out.append('\n');
+    out.appendRepeat('-', 60);
+    out.append('\n');
+
+    for (SymbolHandle handle : sortedSnapshot()) {
+        const SymbolEntry &entry = entries[handle];
         // 1. Symbol (width 20)
-        file << std::left << std::setw(20) << entry.first;
-
-        // 2. Address (width 15)
-        std::stringstream ss;
-        ss << "0x" << std::hex << std::uppercase
-           << std::setfill('0') << std::setw(4) << entry.second.first;
+        out.appendPadded(pool->name(entry.id), 20);
 
-        file << std::left << std::setfill(' ') << std::setw(15) << ss.str();
+        // 2. Address (width 15): "0x" + 오른쪽 정렬 4자리
+        OutputBuffer address(16);
+        address.append("0x");
+        address.appendHexField(entry.address, 4, false, '0');
+        out.appendPadded(address.view(), 15);
 
         // 3. Block (width 10)
-        file << std::left << std::dec << std::setw(10) << entry.second.second << std::endl;
+        out.appendDecimalField(entry.blockNumber, 10, true, ' ');
+        out.append('\n');
     }
-    // ▲▲▲ 수정된 파일 쓰기 루프 ▲▲▲
 
-    file << std::string(60, '=') << std::endl;
-    file.close();
+    out.appendRepeat('=', 60);
+    out.append('\n');
+}
+
+bool SYMTAB::writeToFile(const std::string &filename) const {
+    OutputBuffer out;
+    format(out);
+    if (!out.writeTo(filename)) {
+        Console::err() << "Error: Cannot write SYMTAB file" << std::endl;
+        return false;
+    }
+    return true;
 }
@@ -0,0 +1,86 @@
+#include "../include/assembler.h"
+#include <cstring>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define SOURCEFILE_USE_MMAP 1
+#endif
+
+SourceFile::SourceFile() : data(nullptr), size(0), mapped(false) {}
+
+SourceFile::~SourceFile() {
+    release();
+}
+
+void SourceFile::release() {
+#ifdef SOURCEFILE_USE_MMAP
+    if (mapped) {
+        munmap(const_cast<char *>(data), size);
+    }
+#endif
+    data = nullptr;
+    size = 0;
+    mapped = false;
+    buffer.clear();
+}
+
+bool SourceFile::open(const std::string &filename) {
+    release();
+
+#ifdef SOURCEFILE_USE_MMAP
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode)) {
+        if (st.st_size == 0) {
+            // 빈 파일은 매핑할 수 없으므로 빈 버퍼로 처리
+            ::close(fd);
+            return true;
+        }
+        void *addr = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        if (addr != MAP_FAILED) {
+            madvise(addr, static_cast<size_t>(st.st_size), MADV_SEQUENTIAL);
+            data = static_cast<const char *>(addr);
+            size = static_cast<size_t>(st.st_size);
+            mapped = true;
+            ::close(fd);
+            return true;
+        }
+    }
+    ::close(fd);
+#endif
+
+    // mmap 실패 (파이프, 특수 파일 등) 시 한 번에 읽어들인다
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+    std::ostringstream ss;
+    ss << file.rdbuf();
+    buffer = ss.str();
+    data = buffer.data();
+    size = buffer.size();
+    return true;
+}
+
+std::string_view SourceFile::contents() const {
+    return std::string_view(data, size);
+}
+
+// pos부터 한 라인을 잘라낸다 ('\n' 제외, std::getline과 동일한 규칙)
+bool SourceFile::nextLine(size_t &pos, std::string_view &line) const {
+    if (pos >= size) {
+        return false;
+    }
+    const char *begin = data + pos;
+    const char *nl = static_cast<const char *>(memchr(begin, '\n', size - pos));
+    size_t len = nl ? static_cast<size_t>(nl - begin) : size - pos;
+    line = std::string_view(begin, len);
+    pos += len + 1;
+    return true;
+}
@@ -0,0 +1,243 @@
+#include "../include/assembler.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#include <immintrin.h>
+#define SCANNER_X86 1
+#endif
+
+// 1단계: 64바이트 블록마다 개행('\n')과 필드 구분 공백(' ', \t, \v, \f, \r)의 비트마스크를 만든다
+// 2단계: 비트마스크만 따라가며 라인/단어 경계를 찾는다 (바이트 단위 비교 없음)
+
+static inline bool isFieldSpace(unsigned char c) {
+    return c == ' ' || (c >= '\t' && c <= '\r' && c != '\n');
+}
+
+static void classifyScalar(const char *p, size_t from, size_t n, uint64_t *nl, uint64_t *ws) {
+    for (size_t base = from; base < n; base += 64) {
+        uint64_t nlMask = 0, wsMask = 0;
+        size_t end = std::min(n, base + 64);
+        for (size_t i = base; i < end; ++i) {
+            unsigned char c = static_cast<unsigned char>(p[i]);
+            uint64_t bit = 1ULL << (i - base);
+            if (c == '\n')
+                nlMask |= bit;
+            else if (isFieldSpace(c))
+                wsMask |= bit;
+        }
+        nl[base >> 6] = nlMask;
+        ws[base >> 6] = wsMask;
+    }
+}
+
+#ifdef SCANNER_X86
+__attribute__((target("sse2"))) static void classifySSE2(const char *p, size_t n, uint64_t *nl, uint64_t *ws) {
+    const __m128i newline = _mm_set1_epi8('\n');
+    const __m128i space = _mm_set1_epi8(' ');
+    const __m128i tab = _mm_set1_epi8('\t');
+    const __m128i four = _mm_set1_epi8(4);
+    size_t full = n & ~static_cast<size_t>(63);
+
+    for (size_t base = 0; base < full; base += 64) {
+        uint64_t nlMask = 0, wsMask = 0;
+        for (int k = 0; k < 4; ++k) {
+            __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p + base + 16 * k));
+            __m128i isNl = _mm_cmpeq_epi8(c, newline);
+            // \t..\r 범위 검사: (c - '\t') <= 4 (부호 없는 비교)
+            __m128i d = _mm_sub_epi8(c, tab);
+            __m128i inRange = _mm_cmpeq_epi8(_mm_min_epu8(d, four), d);
+            __m128i isWs = _mm_andnot_si128(isNl, _mm_or_si128(inRange, _mm_cmpeq_epi8(c, space)));
+            nlMask |= static_cast<uint64_t>(static_cast<uint32_t>(_mm_movemask_epi8(isNl))) << (16 * k);
+            wsMask |= static_cast<uint64_t>(static_cast<uint32_t>(_mm_movemask_epi8(isWs))) << (16 * k);
+        }
+        nl[base >> 6] = nlMask;
+        ws[base >> 6] = wsMask;
+    }
+    classifyScalar(p, full, n, nl, ws);
+}
+
+__attribute__((target("avx2"))) static void classifyAVX2(const char *p, size_t n, uint64_t *nl, uint64_t *ws) {
+    const __m256i newline = _mm256_set1_epi8('\n');
+    const __m256i space = _mm256_set1_epi8(' ');
+    const __m256i tab = _mm256_set1_epi8('\t');
+    const __m256i four = _mm256_set1_epi8(4);
+    size_t full = n & ~static_cast<size_t>(63);
+
+    for (size_t base = 0; base < full; base += 64) {
+        uint64_t nlMask = 0, wsMask = 0;
+        for (int k = 0; k < 2; ++k) {
+            __m256i c = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p + base + 32 * k));
+            __m256i isNl = _mm256_cmpeq_epi8(c, newline);
+            __m256i d = _mm256_sub_epi8(c, tab);
+            __m256i inRange = _mm256_cmpeq_epi8(_mm256_min_epu8(d, four), d);
+            __m256i isWs = _mm256_andnot_si256(isNl, _mm256_or_si256(inRange, _mm256_cmpeq_epi8(c, space)));
+            nlMask |= static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(isNl))) << (32 * k);
+            wsMask |= static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(isWs))) << (32 * k);
+        }
+        nl[base >> 6] = nlMask;
+        ws[base >> 6] = wsMask;
+    }
+    classifyScalar(p, full, n, nl, ws);
+}
+#endif
+
+static inline int lowestBit(uint64_t word) {
+#if defined(__GNUC__)
+    return __builtin_ctzll(word);
+#else
+    int pos = 0;
+    while (!(word & 1)) {
+        word >>= 1;
+        pos++;
+    }
+    return pos;
+#endif
+}
+
+static inline int popCount(uint64_t word) {
+#if defined(__GNUC__)
+    return __builtin_popcountll(word);
+#else
+    int count = 0;
+    for (; word; word &= word - 1)
+        count++;
+    return count;
+#endif
+}
+
+static inline int highestBit(uint64_t word) {
+#if defined(__GNUC__)
+    return 63 - __builtin_clzll(word);
+#else
+    int pos = 63;
+    while (!(word & (1ULL << 63))) {
+        word <<= 1;
+        pos--;
+    }
+    return pos;
+#endif
+}
+
+// [from, limit) 에서 비트가 want인 첫 위치 (없으면 limit)
+static inline size_t nextBit(const uint64_t *bits, size_t from, size_t limit, bool want) {
+    while (from < limit) {
+        size_t w = from >> 6;
+        uint64_t word = want ? bits[w] : ~bits[w];
+        word &= ~0ULL << (from & 63);
+        if (word) {
+            size_t pos = (w << 6) + lowestBit(word);
+            return pos < limit ? pos : limit;
+        }
+        from = (w + 1) << 6;
+    }
+    return limit;
+}
+
+// [begin, end) 에서 마지막 공백이 아닌 문자 다음 위치 (없으면 begin)
+static inline size_t lastNonSpace(const uint64_t *ws, size_t begin, size_t end) {
+    while (end > begin) {
+        size_t last = end - 1;
+        size_t w = last >> 6;
+        uint64_t word = ~ws[w];
+        if ((last & 63) != 63)
+            word &= (1ULL << ((last & 63) + 1)) - 1;
+        if (word) {
+            size_t pos = (w << 6) + highestBit(word);
+            return pos >= begin ? pos + 1 : begin;
+        }
+        end = w << 6;
+    }
+    return begin;
+}
+
+SourceScanner::Isa SourceScanner::detect() {
+#ifdef SCANNER_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+        return Isa::AVX2;
+    if (__builtin_cpu_supports("sse2"))
+        return Isa::SSE2;
+#endif
+    return Isa::Scalar;
+}
+
+const char *SourceScanner::isaName(Isa isa) {
+    switch (isa) {
+    case Isa::AVX2:
+        return "AVX2";
+    case Isa::SSE2:
+        return "SSE2";
+    default:
+        return "scalar";
+    }
+}
+
+bool SourceScanner::scan(std::string_view buffer, std::pmr::vector<LineFields> &lines) {
+    static const Isa best = detect();
+    return scan(buffer, lines, best);
+}
+
+bool SourceScanner::scan(std::string_view buffer, std::pmr::vector<LineFields> &lines, Isa isa) {
+    lines.clear();
+    size_t n = buffer.size();
+    if (n >= UINT32_MAX) {
+        Console::err() << "Error: Source file too large (" << n << " bytes)" << std::endl;
+        return false;
+    }
+
+    // 1단계: 비트마스크 생성
+    size_t words = (n + 63) / 64;
+    std::pmr::vector<uint64_t> nl(words, lines.get_allocator()), ws(words, lines.get_allocator());
+    const char *p = buffer.data();
+    switch (isa) {
+#ifdef SCANNER_X86
+    case Isa::AVX2:
+        classifyAVX2(p, n, nl.data(), ws.data());
+        break;
+    case Isa::SSE2:
+        classifySSE2(p, n, nl.data(), ws.data());
+        break;
+#endif
+    default:
+        classifyScalar(p, 0, n, nl.data(), ws.data());
+        break;
+    }
+
+    // 2단계: 라인과 단어 경계 추출 (std::getline과 같은 라인 분할)
+    size_t lineCount = 0;
+    for (size_t w = 0; w < words; ++w) {
+        lineCount += popCount(nl[w]);
+    }
+    lines.reserve(lineCount + 1);
+
+    size_t pos = 0;
+    while (pos < n) {
+        size_t end = nextBit(nl.data(), pos, n, true);
+
+        LineFields f;
+        f.begin = static_cast<uint32_t>(pos);
+        f.end = static_cast<uint32_t>(end);
+        f.flags = 0;
+
+        size_t cursor = pos;
+        for (int t = 0; t < 3; ++t) {
+            size_t start = nextBit(ws.data(), cursor, end, false);
+            f.token[t] = static_cast<uint32_t>(start);
+            if (t < 2) {
+                cursor = nextBit(ws.data(), start, end, true);
+                f.tokenEnd[t] = static_cast<uint32_t>(cursor);
+            }
+        }
+        f.contentEnd = static_cast<uint32_t>(lastNonSpace(ws.data(), f.token[0], end));
+
+        if (f.token[0] == end)
+            f.flags |= LINE_BLANK;
+        if (pos < end && p[pos] == '#')
+            f.flags |= LINE_COMMENT;
+        if (pos < end && p[pos] != ' ' && p[pos] != '\t')
+            f.flags |= LINE_LABELED;
+
+        lines.push_back(f);
+        pos = end + 1;
+    }
+    return true;
+}
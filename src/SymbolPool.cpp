@@ -0,0 +1,34 @@
+#include "../include/assembler.h"
+
+SymbolPool::SymbolPool(std::pmr::memory_resource *memory) : names(memory), index(memory) {}
+
+SymbolPool::SymbolPool(const OPTAB *optab, std::pmr::memory_resource *memory) : names(memory), index(memory) {
+    // 니모닉을 OPTAB 등록 순서대로 먼저 넣어 두면 ID가 곧 OPTAB 인덱스가 된다
+    for (size_t i = 0; i < optab->size(); ++i) {
+        intern(optab->getMnemonic(i));
+    }
+}
+
+SymbolId SymbolPool::intern(std::string_view name) {
+    auto it = index.find(name);
+    if (it != index.end()) {
+        return it->second;
+    }
+    SymbolId id = static_cast<SymbolId>(names.size());
+    names.emplace_back(name);
+    index.emplace(names.back(), id);
+    return id;
+}
+
+SymbolId SymbolPool::find(std::string_view name) const {
+    auto it = index.find(name);
+    return it != index.end() ? it->second : NO_SYMBOL;
+}
+
+std::string_view SymbolPool::name(SymbolId id) const {
+    return id < names.size() ? std::string_view(names[id]) : std::string_view();
+}
+
+size_t SymbolPool::size() const {
+    return names.size();
+}
@@ -0,0 +1,88 @@
+#include "../include/assembler.h"
+
+ThreadPool::ThreadPool(size_t threads)
+    : task(nullptr), next(0), total(0), finished(0), stopping(false) {
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    // 호출 스레드가 하나를 맡으므로 작업 스레드는 하나 적게 만든다
+    for (size_t i = 1; i < threads; ++i) {
+        workers.emplace_back(&ThreadPool::workerLoop, this);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (std::thread &worker : workers) {
+        worker.join();
+    }
+}
+
+size_t ThreadPool::size() const {
+    return workers.size() + 1;
+}
+
+void ThreadPool::workerLoop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    for (;;) {
+        wake.wait(lock, [this] { return stopping || next < total; });
+        if (stopping) {
+            return;
+        }
+        runIndex(lock, next++);
+        if (++finished == total) {
+            done.notify_all();
+        }
+    }
+}
+
+// 잠금을 풀고 인덱스 하나를 처리한다 (예외는 첫 것만 남기고 나머지 인덱스는 계속 처리)
+void ThreadPool::runIndex(std::unique_lock<std::mutex> &lock, size_t index) {
+    const std::function<void(size_t)> *body = task;
+    lock.unlock();
+    std::exception_ptr error;
+    try {
+        (*body)(index);
+    } catch (...) {
+        error = std::current_exception();
+    }
+    lock.lock();
+    if (error && !failure) {
+        failure = error;
+    }
+}
+
+void ThreadPool::run(size_t count, const std::function<void(size_t)> &body) {
+    if (workers.empty() || count <= 1) {
+        for (size_t i = 0; i < count; ++i) {
+            body(i);
+        }
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(mutex);
+    task = &body;
+    next = 0;
+    total = count;
+    finished = 0;
+    failure = nullptr;
+    wake.notify_all();
+
+    // 호출 스레드도 남은 인덱스를 가져가 처리
+    while (next < total) {
+        runIndex(lock, next++);
+        ++finished;
+    }
+    // 작업 스레드가 아직 body를 쓰는 동안에는 돌아가지 않는다
+    done.wait(lock, [this] { return finished == total; });
+    task = nullptr;
+    if (failure) {
+        std::exception_ptr error = failure;
+        failure = nullptr;
+        std::rethrow_exception(error);
+    }
+}
@@ -0,0 +1,60 @@
+#include "../include/assembler.h"
+
+WorkStealingPool::WorkStealingPool(size_t count) : threads(count) {
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+}
+
+size_t WorkStealingPool::size() const {
+    return threads;
+}
+
+bool WorkStealingPool::take(Queue &queue, size_t &index) {
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.items.empty()) {
+        return false;
+    }
+    index = queue.items.front();
+    queue.items.pop_front();
+    return true;
+}
+
+void WorkStealingPool::run(size_t count, const std::function<void(size_t)> &body) {
+    size_t active = std::min(threads, count);
+    if (active <= 1) {
+        for (size_t i = 0; i < count; ++i) {
+            body(i);
+        }
+        return;
+    }
+
+    // 돌아가며 나눠 담으면 각 큐도 앞 인덱스(큰 작업)부터 시작한다
+    std::vector<Queue> queues(active);
+    for (size_t i = 0; i < count; ++i) {
+        queues[i % active].items.push_back(i);
+    }
+
+    // 새 작업은 생기지 않으므로 모든 큐가 비면 끝
+    auto work = [&](size_t self) {
+        size_t index = 0;
+        for (;;) {
+            bool found = take(queues[self], index);
+            for (size_t k = 1; !found && k < active; ++k) {
+                found = take(queues[(self + k) % active], index);
+            }
+            if (!found) {
+                return;
+            }
+            body(index);
+        }
+    };
+    std::vector<std::thread> workers;
+    for (size_t t = 1; t < active; ++t) {
+        workers.emplace_back(work, t);
+    }
+    work(0);
+    for (std::thread &worker : workers) {
+        worker.join();
+    }
+}
@@ -1,80 +1,383 @@
 #include "../include/assembler.h"
+#include <chrono>
+#include <sys/stat.h>
 
-int main() {
-    std::cout << "\n"
-              << std::string(70, '=') << std::endl;
-    std::cout << "           SIC/XE ASSEMBLER" << std::endl;
-    std::cout << std::string(70, '=') << std::endl;
+// 아레나 첫 블록 크기 (이후 블록은 자동으로 커진다)
+static const size_t ARENA_INITIAL_SIZE = 1 << 20;
+// --watch: 소스 파일 변경 확인 간격
+static const int WATCH_INTERVAL_MS = 200;
+// --one-pass: 한 번에 어셈블할 수 없는 구조라 2패스로 다시 실행해야 할 때의 반환값
+static const int ONE_PASS_FALLBACK = -1;
 
-    // 1. OPTAB 로드
-    std::cout << "\n[Step 1] Loading OPTAB..." << std::endl;
+// 콘솔 리스팅은 켜져 있고 보일 때만 만든다 (아니면 포맷 작업 자체를 건너뛴다)
+static bool showListing(uint32_t emit) {
+    return (emit & Emit::LISTING) != 0 && Console::enabled(LogLevel::VERBOSE);
+}
+
+// 리스팅이 없으면 OBJFILE은 Pass 2 도중에 레코드 단위로 쓴다 (오브젝트 코드를 끝까지 들고 있지 않는다)
+static bool streamObject(uint32_t emit) {
+    return (emit & Emit::OBJFILE) != 0 && !showListing(emit);
+}
+
+// 저장된 이진 중간 파일로 Pass 2만 실행 (Pass 1 결과 재사용)
+static int runPass2Only(OPTAB &optab, const std::string &intFilename, uint32_t emit) {
+    std::pmr::monotonic_buffer_resource arena(ARENA_INITIAL_SIZE);
+    SymbolPool pool(&optab, &arena);
+    SYMTAB symtab(&pool, &arena);
+    LITTAB littab(&pool, &arena);
+    IntermediateFile intermediate(&arena);
+    ThreadPool workers;
+
+    Console::out() << "\n[Step 2] Loading intermediate file..." << std::endl;
+    if (!intermediate.load(intFilename, &symtab, &littab, &pool)) {
+        Console::err() << "Failed to load intermediate file. Exiting..." << std::endl;
+        return 1;
+    }
+    // 텍스트 INTFILE은 이진 파일에서 다시 만든다 (Pass 2와 동시에 백그라운드에서)
+    ArtifactWriter writer;
+    if ((emit & Emit::INTFILE) != 0) {
+        writer.add([&]() {
+            return IntermediateFile::writeText("output/INTFILE", intermediate.getIntFile(),
+                                               intermediate.getProgramBlocks(), pool);
+        });
+    }
+    writer.start();
+
+    Pass2 pass2(&optab, &symtab, &littab, &pool, intermediate.getIntFile(),
+                intermediate.getStartAddress(), intermediate.getProgramLength(),
+                intermediate.getProgramName(), intermediate.getProgramBlocks(), &arena, &workers);
+    if (streamObject(emit) && !pass2.streamTo("output/OBJFILE")) {
+        return 1;
+    }
+    if (!pass2.execute()) {
+        Console::err() << "Pass 2 failed. Exiting..." << std::endl;
+        return 1;
+    }
+    if ((emit & Emit::OBJFILE) != 0 && !streamObject(emit)) {
+        pass2.writeObjFile("output/OBJFILE");
+    }
+    if (!writer.finish()) {
+        return 1;
+    }
+    if (showListing(emit)) {
+        pass2.printListingFile();
+        pass2.printObjFile();
+    }
+    return 0;
+}
+
+// 원패스 모드: 중간 파일 없이 읽으면서 바로 인코딩
+// (구조상 안 되면 ONE_PASS_FALLBACK, 호출한 쪽에서 2패스로 다시 실행)
+static int runOnePass(OPTAB &optab, uint32_t emit) {
+    std::pmr::monotonic_buffer_resource arena(ARENA_INITIAL_SIZE);
+    SymbolPool pool(&optab, &arena);
+    SYMTAB symtab(&pool, &arena);
+    LITTAB littab(&pool, &arena);
+    ThreadPool workers;
+    Pass1 pass1(&optab, &symtab, &littab, &pool, &arena, &workers);
+    OnePassEncoder encoder(&optab, &symtab, &littab, &pool, &arena);
+    pass1.setEncoder(&encoder);
+
+    // 2패스로 다시 실행하면 같은 메시지가 또 나오므로 결과가 정해질 때까지 모아 두었다가,
+    // 되돌아갈 때는 버린다 (출력 수준은 모을 때 적용)
+    std::ostringstream progress;
+    std::ostringstream diagnostics;
+    bool parsed = false;
+    bool encoded = false;
+    {
+        ConsoleRedirect capture(&progress, &diagnostics, true);
+        Console::out() << "\n[Step 2] Running one-pass assembly..." << std::endl;
+        parsed = pass1.execute("input/SRCFILE");
+        encoded = parsed && encoder.finish(pass1);
+    }
+    if (parsed && !encoded) {
+        return ONE_PASS_FALLBACK;
+    }
+    Console::out() << progress.str();
+    Console::err() << diagnostics.str();
+    if (!parsed) {
+        Console::err() << "Pass 1 failed. Exiting..." << std::endl;
+        return 1;
+    }
+    symtab.setProgramBlocks(&(pass1.getProgramBlocks()));
+    if ((emit & Emit::SYMTAB) != 0) {
+        symtab.writeToFile("output/SYMTAB.txt");
+    }
+    if ((emit & Emit::LITTAB) != 0) {
+        littab.writeToFile("output/LITTAB.txt");
+    }
+    if ((emit & Emit::OBJFILE) != 0) {
+        encoder.writeObjFile("output/OBJFILE");
+    }
+    if (showListing(emit)) {
+        encoder.printObjFile();
+    }
+
+    Console::out() << "\n✓ All output files generated successfully!" << std::endl;
+    if ((emit & Emit::SYMTAB) != 0) {
+        Console::out() << "  - output/SYMTAB.txt (Symbol table)" << std::endl;
+    }
+    if ((emit & Emit::OBJFILE) != 0) {
+        Console::out() << "  - output/OBJFILE (Object program)" << std::endl;
+    }
+    if ((emit & Emit::LITTAB) != 0) {
+        Console::out() << "  - output/LITTAB.txt (Literal table)" << std::endl;
+    }
+    return 0;
+}
+
+// 소스 파일을 지켜보다가 바뀔 때마다 바뀐 줄만 다시 어셈블하고 산출물을 다시 쓴다 (Ctrl+C로 종료)
+static int runWatch(OPTAB &optab, uint32_t emit) {
+    ThreadPool workers;
+    IncrementalAssembler assembler(&optab, &workers);
+    Console::out() << "\n[Step 2] Watching input/SRCFILE..." << std::endl;
+    Console::flush();
+
+    bool seen = false;
+    struct stat last {};
+    for (;;) {
+        struct stat st {};
+        bool changed = stat("input/SRCFILE", &st) == 0 &&
+                       (!seen || st.st_size != last.st_size || st.st_mtim.tv_sec != last.st_mtim.tv_sec ||
+                        st.st_mtim.tv_nsec != last.st_mtim.tv_nsec);
+        if (changed) {
+            seen = true;
+            last = st;
+            if (assembler.assemble("input/SRCFILE")) {
+                assembler.writeOutputs(emit);
+            } else {
+                Console::err() << "Assembly failed, waiting for the next change..." << std::endl;
+            }
+            Console::flush();
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(WATCH_INTERVAL_MS));
+    }
+}
+
+// 배치 모드: 여러 소스를 작업 훔치기 스레드 풀에서 동시에 어셈블 (OPTAB은 모든 작업이 공유)
+static int runBatch(const OPTAB &optab, const std::vector<std::string> &sources, const std::string &manifest,
+                    size_t threads, uint32_t emit) {
+    BatchAssembler batch(&optab, emit);
+    if (!manifest.empty() && !batch.addManifest(manifest)) {
+        return 1;
+    }
+    for (const std::string &source : sources) {
+        batch.add(source);
+    }
+    Console::out() << "\n[Step 2] Assembling " << batch.size() << " source files..." << std::endl;
+    return batch.run(threads) == 0 ? 0 : 1;
+}
+
+// 상주 서버 모드: OPTAB을 한 번 준비해 두고 Unix 소켓으로 요청을 받는다 (client/로 요청)
+static int runServer(const OPTAB &optab, const std::string &socketPath, size_t threads) {
+    AssemblerServer server(&optab, socketPath, threads);
+    Console::out() << "\n[Step 2] Starting assembler server..." << std::endl;
+    if (!server.start()) {
+        return 1;
+    }
+    Console::flush();
+    server.run();
+    Console::out() << "Assembler server stopped" << std::endl;
+    return 0;
+}
+
+int main(int argc, char *argv[]) {
+    // 옵션: --pass2 <INTFILE.bin>  저장된 Pass 1 결과로 Pass 2만 실행
+    //       --one-pass             중간 파일 없이 한 번에 어셈블 (fixup 체인으로 전방 참조 처리)
+    //       --watch                소스가 바뀔 때마다 바뀐 부분만 다시 어셈블
+    //       --batch <소스>...      여러 소스를 동시에 어셈블 (산출물은 output/<이름>/)
+    //       --manifest <파일>      배치 목록 파일 (한 줄에 "소스 [출력 디렉터리]")
+    //       --serve [소켓 경로]    상주 서버로 실행 (생략하면 AssemblerProtocol::DEFAULT_SOCKET)
+    //       --jobs <n>             배치/서버 스레드 수 (생략하면 하드웨어 스레드 수)
+    //       --log-level <수준>     silent | errors | summary | verbose (기본 verbose)
+    //       -q, --quiet            --log-level errors와 같다
+    //       --emit <목록>          만들 산출물 (objfile,intfile,intbin,symtab,littab,listing / all / none, 기본 all)
+    std::string pass2From;
+    bool onePass = false;
+    bool watch = false;
+    bool batch = false;
+    std::vector<std::string> batchSources;
+    std::string manifest;
+    size_t jobs = 0;
+    std::string serveSocket;
+    LogLevel level = LogLevel::VERBOSE;
+    uint32_t emit = Emit::ALL;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--pass2" && i + 1 < argc) {
+            pass2From = argv[++i];
+        } else if (arg == "--one-pass") {
+            onePass = true;
+        } else if (arg == "--watch") {
+            watch = true;
+        } else if (arg == "--batch") {
+            batch = true;
+        } else if (arg == "--manifest" && i + 1 < argc) {
+            batch = true;
+            manifest = argv[++i];
+        } else if (arg == "--serve") {
+            serveSocket = i + 1 < argc && argv[i + 1][0] != '-' ? argv[++i] : AssemblerProtocol::DEFAULT_SOCKET;
+        } else if (arg == "--jobs" && i + 1 < argc) {
+            jobs = static_cast<size_t>(std::max(0, std::atoi(argv[++i])));
+        } else if (arg == "--log-level" && i + 1 < argc && Console::parseLevel(argv[i + 1], level)) {
+            ++i;
+        } else if (arg == "-q" || arg == "--quiet") {
+            level = LogLevel::ERRORS;
+        } else if (arg == "--emit" && i + 1 < argc && Emit::parse(argv[i + 1], emit)) {
+            ++i;
+        } else if (batch && arg.compare(0, 2, "--") != 0) {
+            batchSources.push_back(arg);
+        } else {
+            Console::err() << "Usage: " << argv[0]
+                           << " [--pass2 <INTFILE.bin> | --one-pass | --watch |"
+                              " --batch <source>... | --manifest <file> | --serve [socket]] [--jobs <n>]"
+                              " [--log-level silent|errors|summary|verbose | -q] [--emit <artifact,...>]"
+                           << std::endl;
+            return 1;
+        }
+    }
+    Console::setLevel(level);
+
+    Console::out() << "\n"
+                   << std::string(70, '=') << std::endl;
+    Console::out() << "           SIC/XE ASSEMBLER" << std::endl;
+    Console::out() << std::string(70, '=') << std::endl;
+
+    // 1. OPTAB 준비 (내장 명령어 집합, input/optab.txt가 있으면 추가/재정의)
+    Console::out() << "\n[Step 1] Loading OPTAB..." << std::endl;
     OPTAB optab;
-    if (!optab.load("input/optab.txt")) {
-        std::cerr << "Failed to load OPTAB. Exiting..." << std::endl;
+    if (std::ifstream("input/optab.txt").good() && !optab.load("input/optab.txt")) {
+        Console::err() << "Failed to load OPTAB. Exiting..." << std::endl;
         return 1;
     }
+    Console::out() << "OPTAB ready: " << optab.size() << " instructions" << std::endl;
+
+    if (!pass2From.empty()) {
+        return runPass2Only(optab, pass2From, emit);
+    }
+    if (batch) {
+        return runBatch(optab, batchSources, manifest, jobs, emit);
+    }
+    if (!serveSocket.empty()) {
+        return runServer(optab, serveSocket, jobs);
+    }
+    if (watch) {
+        return runWatch(optab, emit);
+    }
+    if (onePass) {
+        int result = runOnePass(optab, emit);
+        if (result != ONE_PASS_FALLBACK) {
+            return result;
+        }
+        Console::out() << "\nOne-pass assembly needs a single START and an END directive, falling back to two passes"
+                       << std::endl;
+    }
+
+    // 식별자 풀 (OPTAB 니모닉을 먼저 등록)
+    // 어셈블리 한 번 동안의 테이블/IR은 모두 이 아레나에서 할당하고 끝날 때 한꺼번에 해제
+    std::pmr::monotonic_buffer_resource arena(ARENA_INITIAL_SIZE);
+    SymbolPool pool(&optab, &arena);
 
     // 2. SYMTAB 생성
-    std::cout << "\n[Step 2] Initializing SYMTAB..." << std::endl;
-    SYMTAB symtab;
-    std::cout << "SYMTAB initialized successfully" << std::endl;
+    Console::out() << "\n[Step 2] Initializing SYMTAB..." << std::endl;
+    SYMTAB symtab(&pool, &arena);
+    Console::out() << "SYMTAB initialized successfully" << std::endl;
 
     // LITTAB 생성 (추가)
-    std::cout << "\n[Step 3] Initializing LITTAB..." << std::endl;
-    LITTAB littab;
-    std::cout << "LITTAB initialized successfully" << std::endl;
+    Console::out() << "\n[Step 3] Initializing LITTAB..." << std::endl;
+    LITTAB littab(&pool, &arena);
+    Console::out() << "LITTAB initialized successfully" << std::endl;
 
-    // 3. Pass 1 실행
-    std::cout << "\n[Step 4] Running Pass 1..." << std::endl;
-    Pass1 pass1(&optab, &symtab, &littab);
+    // 3. Pass 1 실행 (큰 프로그램은 파싱/분류/길이 계산과 Pass 2 인코딩을 여러 스레드에서 처리)
+    Console::out() << "\n[Step 4] Running Pass 1..." << std::endl;
+    ThreadPool workers;
+    Pass1 pass1(&optab, &symtab, &littab, &pool, &arena, &workers);
 
     if (!pass1.execute("input/SRCFILE")) {
-        std::cerr << "Pass 1 failed. Exiting..." << std::endl;
+        Console::err() << "Pass 1 failed. Exiting..." << std::endl;
         return 1;
     }
 
-    // Pass 1 결과 (중간파일) 저장
-    pass1.writeIntFile("output/INTFILE");
-    // SYMTAB 파일 저장
+    // Pass 1 결과 (중간파일, SYMTAB, 이진 중간 파일, LITTAB)는 Pass 2와 동시에 백그라운드에서 쓴다
+    // (이후 테이블은 읽기만 하므로 그대로 넘기고, 쓰기 메시지는 Pass 2가 끝난 뒤 출력된다)
     symtab.setProgramBlocks(&(pass1.getProgramBlocks()));
-    symtab.writeToFile("output/SYMTAB.txt");
-    std::cout << "Pass 1 output (INTFILE, SYMTAB.txt) saved." << std::endl;
+    ArtifactWriter writer;
+    if ((emit & Emit::INTFILE) != 0) {
+        writer.add([&pass1]() { return pass1.writeIntFile("output/INTFILE"); });
+    }
+    if ((emit & Emit::SYMTAB) != 0) {
+        writer.add([&symtab]() { return symtab.writeToFile("output/SYMTAB.txt"); });
+    }
+    // 이진 중간 파일 (--pass2로 Pass 2만 다시 실행할 때 사용)
+    if ((emit & Emit::INTFILE_BIN) != 0) {
+        writer.add([&]() { return IntermediateFile::write("output/INTFILE.bin", pass1, symtab, littab, pool); });
+    }
+    if ((emit & Emit::LITTAB) != 0) {
+        writer.add([&littab]() { return littab.writeToFile("output/LITTAB.txt"); });
+    }
+    writer.start();
+
     // 프로그램 정보
     int startAddress = pass1.getStartAddress();
     int programLength = pass1.getProgramLength();
     std::string programName = pass1.getProgramName();
 
-    // LITTAB 파일 저장
-    littab.writeToFile("output/LITTAB.txt");
-    std::cout << "LITTAB.txt saved." << std::endl;
-
-    // 4. Pass 2 실행
-    Pass2 pass2(&optab, &symtab, &littab, pass1.getIntFile(),
+    // 4. Pass 2 실행 (실패해도 writer의 소멸자가 쓰기를 마치고 합류한다)
+    Pass2 pass2(&optab, &symtab, &littab, &pool, pass1.getIntFile(),
                 startAddress, programLength, programName,
-                pass1.getProgramBlocks());
+                pass1.getProgramBlocks(), &arena, &workers);
+    if (streamObject(emit) && !pass2.streamTo("output/OBJFILE")) {
+        return 1;
+    }
     if (!pass2.execute()) {
-        std::cerr << "Pass 2 failed. Exiting..." << std::endl;
+        Console::err() << "Pass 2 failed. Exiting..." << std::endl;
         return 1;
     }
     // Pass 2 결과 (오브젝트 파일) 저장
-    pass2.writeObjFile("output/OBJFILE");
+    if ((emit & Emit::OBJFILE) != 0 && !streamObject(emit)) {
+        pass2.writeObjFile("output/OBJFILE");
+    }
+
+    if (!writer.finish()) {
+        Console::err() << "Failed to write Pass 1 output. Exiting..." << std::endl;
+        return 1;
+    }
+    if ((emit & (Emit::INTFILE | Emit::SYMTAB)) == (Emit::INTFILE | Emit::SYMTAB)) {
+        Console::out() << "Pass 1 output (INTFILE, SYMTAB.txt) saved." << std::endl;
+    }
+    if ((emit & Emit::LITTAB) != 0) {
+        Console::out() << "LITTAB.txt saved." << std::endl;
+    }
 
     // 5. 최종 결과 출력
-    std::cout << "\n"
-              << std::string(70, '=') << std::endl;
-    std::cout << "     ASSEMBLY COMPLETED SUCCESSFULLY" << std::endl;
-    std::cout << std::string(70, '=') << std::endl;
-
-    // 최종 리스팅 파일 (objcode 포함)
-    pass2.printListingFile();
-    // 최종 오브젝트 파일
-    pass2.printObjFile();
-
-    std::cout << "\n✓ All output files generated successfully!" << std::endl;
-    std::cout << "  - output/INTFILE (Pass 1 output)" << std::endl;
-    std::cout << "  - output/SYMTAB.txt (Symbol table)" << std::endl;
-    std::cout << "  - output/OBJFILE (Pass 2 output)" << std::endl;
-    std::cout << "  - output/LITTAB.txt (Literal table)" << std::endl;
+    Console::out() << "\n"
+                   << std::string(70, '=') << std::endl;
+    Console::out() << "     ASSEMBLY COMPLETED SUCCESSFULLY" << std::endl;
+    Console::out() << std::string(70, '=') << std::endl;
+
+    if (showListing(emit)) {
+        // 최종 리스팅 파일 (objcode 포함)
+        pass2.printListingFile();
+        // 최종 오브젝트 파일
+        pass2.printObjFile();
+    }
+
+    Console::out() << "\n✓ All output files generated successfully!" << std::endl;
+    if ((emit & Emit::INTFILE) != 0) {
+        Console::out() << "  - output/INTFILE (Pass 1 output)" << std::endl;
+    }
+    if ((emit & Emit::INTFILE_BIN) != 0) {
+        Console::out() << "  - output/INTFILE.bin (Pass 1 output, binary)" << std::endl;
+    }
+    if ((emit & Emit::SYMTAB) != 0) {
+        Console::out() << "  - output/SYMTAB.txt (Symbol table)" << std::endl;
+    }
+    if ((emit & Emit::OBJFILE) != 0) {
+        Console::out() << "  - output/OBJFILE (Pass 2 output)" << std::endl;
+    }
+    if ((emit & Emit::LITTAB) != 0) {
+        Console::out() << "  - output/LITTAB.txt (Literal table)" << std::endl;
+    }
 
     return 0;
 }
\ No newline at end of file